@@ -0,0 +1,101 @@
+/* benchmark of chessAddGames against calling chessAddGame for every game of a feed */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NUM_OF_TOURNAMENTS 10
+#define NUM_OF_PARTICIPANTS 20000
+#define GAMES_PER_PLAYER 5
+#define MAX_PLAY_TIME 3600
+#define BATCH_SIZE 4096
+#define NUM_OF_GAMES (NUM_OF_TOURNAMENTS * NUM_OF_PARTICIPANTS * GAMES_PER_PLAYER)
+
+static double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// every player of every tournament plays GAMES_PER_PLAYER games against the players after him in the ring
+static void makeFeed(GameRecord* records) {
+    srand(NUM_OF_PARTICIPANTS);
+    int index = 0;
+    for (int tournament_id = 1; tournament_id <= NUM_OF_TOURNAMENTS; tournament_id++) {
+        for (int i = 0; i < NUM_OF_PARTICIPANTS; i++) {
+            for (int distance = 1; distance <= GAMES_PER_PLAYER; distance++) {
+                GameRecord record = { tournament_id, i + 1, (i + distance) % NUM_OF_PARTICIPANTS + 1,
+                                      (Winner)(rand() % 3), rand() % MAX_PLAY_TIME + 1 };
+                records[index++] = record;
+            }
+        }
+    }
+}
+
+static ChessSystem createSystem() {
+    ChessSystem chess = chessCreate();
+    if (chess == NULL) {
+        return NULL;
+    }
+    for (int tournament_id = 1; tournament_id <= NUM_OF_TOURNAMENTS; tournament_id++) {
+        if (chessAddTournament(chess, tournament_id, 2 * GAMES_PER_PLAYER, "Location") != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            return NULL;
+        }
+    }
+    return chess;
+}
+
+static int benchSingle(const GameRecord* records) {
+    ChessSystem chess = createSystem();
+    if (chess == NULL) {
+        return 1;
+    }
+    double start = now();
+    for (int i = 0; i < NUM_OF_GAMES; i++) {
+        if (chessAddGame(chess, records[i].tournament_id, records[i].first_player, records[i].second_player,
+                         records[i].winner, records[i].play_time) != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            return 1;
+        }
+    }
+    double seconds = now() - start;
+    printf("chessAddGame:  %d games: %.1f ms\n", NUM_OF_GAMES, seconds * 1e3);
+    chessDestroy(chess);
+    return 0;
+}
+
+static int benchBatch(const GameRecord* records) {
+    ChessSystem chess = createSystem();
+    if (chess == NULL) {
+        return 1;
+    }
+    double start = now();
+    for (int i = 0; i < NUM_OF_GAMES; i += BATCH_SIZE) {
+        int n = NUM_OF_GAMES - i < BATCH_SIZE ? NUM_OF_GAMES - i : BATCH_SIZE;
+        if (chessAddGames(chess, records + i, n, NULL) != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            return 1;
+        }
+    }
+    double seconds = now() - start;
+    printf("chessAddGames: %d games in batches of %d: %.1f ms\n", NUM_OF_GAMES, BATCH_SIZE, seconds * 1e3);
+    chessDestroy(chess);
+    return 0;
+}
+
+int main() {
+    GameRecord* records = malloc(sizeof(*records) * NUM_OF_GAMES);
+    if (records == NULL) {
+        return 1;
+    }
+    makeFeed(records);
+    int result = benchSingle(records) || benchBatch(records);
+    free(records);
+    return result;
+}
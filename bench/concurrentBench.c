@@ -0,0 +1,268 @@
+/* throughput of chessAddGame called by several threads at once.
+ * usage: concurrentBench [max_threads [games_per_thread]]
+ *        concurrentBench check [threads [games_per_thread]]
+ * every thread adds games to tournaments of its own, between players drawn from one pool shared by all threads,
+ * and now and then asks for the average play time of a player. the games run either behind one global mutex,
+ * the way a system that isn't thread safe has to be shared, or on a system made thread safe with
+ * chessSetThreadSafe. the results are printed as one JSON object per line, for 1, 2, 4 and so on threads.
+ * check runs the threads on a thread safe system, runs the same games from one thread on a system that isn't,
+ * and compares the saved levels and tournament statistics of both. build it with -fsanitize=thread to also
+ * check the locking (make tsan). */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#define DEFAULT_MAX_THREADS 8
+#define DEFAULT_GAMES_PER_THREAD 200000
+#define PLAYERS_NUM 20000
+#define TOURNAMENTS_PER_THREAD 16
+#define MAX_GAMES_PER_PLAYER 1000
+#define MAX_PLAY_TIME 3600
+// one operation in this many asks for an average play time instead of adding a game
+#define QUERY_PERIOD 16
+// every player plays a game in this tournament before the threads start, so the threads find every player
+#define WARM_UP_TOURNAMENT 1
+#define THREADS_FIRST_TOURNAMENT 2
+#define LEVELS_PATH "concurrentBenchLevels%d.txt"
+#define STATISTICS_PATH "concurrentBenchStatistics%d.txt"
+#define PATH_SIZE 64
+
+typedef struct {
+    ChessSystem chess;
+    pthread_mutex_t* mutex; // NULL if the system is thread safe
+    int index;
+    int games_num;
+    int results[CHESS_SUCCESS + 1];
+    pthread_t thread;
+} Worker;
+
+// xorshift64*, seeded by the index of the thread, so a thread makes the same calls in every run
+static uint64_t nextRandom(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * UINT64_C(2685821657736338717);
+}
+
+static double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+static void lock(Worker* worker) {
+    if (worker->mutex != NULL) {
+        pthread_mutex_lock(worker->mutex);
+    }
+}
+
+static void unlock(Worker* worker) {
+    if (worker->mutex != NULL) {
+        pthread_mutex_unlock(worker->mutex);
+    }
+}
+
+static void* runWorker(void* context) {
+    Worker* worker = context;
+    uint64_t random_state = (worker->index + 1) * UINT64_C(0x9E3779B97F4A7C15);
+    int first_tournament = THREADS_FIRST_TOURNAMENT + worker->index * TOURNAMENTS_PER_THREAD;
+    for (int i = 0; i < worker->games_num; i++) {
+        int first_player = nextRandom(&random_state) % PLAYERS_NUM + 1;
+        if (i % QUERY_PERIOD == QUERY_PERIOD - 1) {
+            ChessResult result;
+            lock(worker);
+            chessCalculateAveragePlayTime(worker->chess, first_player, &result);
+            unlock(worker);
+            continue;
+        }
+        int second_player = nextRandom(&random_state) % PLAYERS_NUM + 1;
+        int tournament_id = first_tournament + nextRandom(&random_state) % TOURNAMENTS_PER_THREAD;
+        Winner winner = (Winner)(nextRandom(&random_state) % 3);
+        int play_time = nextRandom(&random_state) % MAX_PLAY_TIME + 1;
+        lock(worker);
+        ChessResult result = chessAddGame(worker->chess, tournament_id, first_player, second_player, winner,
+                                          play_time);
+        unlock(worker);
+        worker->results[result]++;
+    }
+    return NULL;
+}
+
+// a system with the tournaments of every thread, in which every player already played a game
+static ChessSystem createSystem(int threads_num) {
+    ChessSystem chess = chessCreate();
+    if (chess == NULL) {
+        return NULL;
+    }
+    int tournaments_num = THREADS_FIRST_TOURNAMENT + threads_num * TOURNAMENTS_PER_THREAD;
+    for (int id = WARM_UP_TOURNAMENT; id < tournaments_num; id++) {
+        if (chessAddTournament(chess, id, MAX_GAMES_PER_PLAYER, "Location") != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            return NULL;
+        }
+    }
+    for (int player = 1; player < PLAYERS_NUM; player += 2) {
+        chessAddGame(chess, WARM_UP_TOURNAMENT, player, player + 1, DRAW, 1);
+    }
+    return chess;
+}
+
+// runs the workers, from threads of their own or one after the other from this thread
+static bool runWorkers(Worker* workers, int threads_num, bool is_concurrent) {
+    if (!is_concurrent) {
+        for (int i = 0; i < threads_num; i++) {
+            runWorker(&workers[i]);
+        }
+        return true;
+    }
+    bool is_done = true;
+    int started = 0;
+    while (started < threads_num && pthread_create(&workers[started].thread, NULL, runWorker,
+                                                   &workers[started]) == 0) {
+        started++;
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    if (started < threads_num) {
+        fprintf(stderr, "couldn't start %d threads\n", threads_num);
+        is_done = false;
+    }
+    return is_done;
+}
+
+static Worker* createWorkers(ChessSystem chess, pthread_mutex_t* mutex, int threads_num, int games_num) {
+    Worker* workers = calloc(threads_num, sizeof(*workers));
+    for (int i = 0; workers != NULL && i < threads_num; i++) {
+        workers[i].chess = chess;
+        workers[i].mutex = mutex;
+        workers[i].index = i;
+        workers[i].games_num = games_num;
+    }
+    return workers;
+}
+
+static bool measure(int threads_num, int games_num, bool is_thread_safe) {
+    ChessSystem chess = createSystem(threads_num);
+    pthread_mutex_t mutex;
+    pthread_mutex_init(&mutex, NULL);
+    Worker* workers = createWorkers(chess, is_thread_safe ? NULL : &mutex, threads_num, games_num);
+    bool is_done = chess != NULL && workers != NULL &&
+                   (!is_thread_safe || chessSetThreadSafe(chess, true) == CHESS_SUCCESS);
+    double start = now();
+    is_done = is_done && runWorkers(workers, threads_num, true);
+    double seconds = now() - start;
+    if (is_done) {
+        long calls = (long)threads_num * games_num;
+        int failures = 0;
+        for (int i = 0; i < threads_num; i++) {
+            for (int result = 0; result < CHESS_SUCCESS; result++) {
+                failures += workers[i].results[result];
+            }
+        }
+        printf("{\"mode\":\"%s\",\"threads\":%d,\"calls\":%ld,\"failed_games\":%d,\"seconds\":%.3f,"
+               "\"calls_per_second\":%.0f}\n", is_thread_safe ? "thread_safe" : "global_mutex", threads_num,
+               calls, failures, seconds, calls / seconds);
+    }
+    free(workers);
+    pthread_mutex_destroy(&mutex);
+    chessDestroy(chess);
+    return is_done;
+}
+
+// ends the tournaments of a system and saves its levels and statistics, to files named after the index
+static bool save(ChessSystem chess, int threads_num, int index) {
+    int tournaments_num = THREADS_FIRST_TOURNAMENT + threads_num * TOURNAMENTS_PER_THREAD;
+    for (int id = WARM_UP_TOURNAMENT; id < tournaments_num; id++) {
+        chessEndTournament(chess, id);
+    }
+    char path[PATH_SIZE];
+    sprintf(path, LEVELS_PATH, index);
+    FILE* levels = fopen(path, "w");
+    if (levels == NULL) {
+        return false;
+    }
+    bool is_saved = chessSavePlayersLevels(chess, levels) == CHESS_SUCCESS;
+    fclose(levels);
+    sprintf(path, STATISTICS_PATH, index);
+    return is_saved && chessSaveTournamentStatistics(chess, path) == CHESS_SUCCESS;
+}
+
+static bool isSameFile(const char* path_format, int first_index, int second_index) {
+    char first_path[PATH_SIZE], second_path[PATH_SIZE];
+    sprintf(first_path, path_format, first_index);
+    sprintf(second_path, path_format, second_index);
+    FILE* first = fopen(first_path, "r");
+    FILE* second = fopen(second_path, "r");
+    bool is_same = first != NULL && second != NULL;
+    while (is_same) {
+        int c = fgetc(first);
+        is_same = c == fgetc(second);
+        if (c == EOF) {
+            break;
+        }
+    }
+    if (first != NULL) {
+        fclose(first);
+    }
+    if (second != NULL) {
+        fclose(second);
+    }
+    remove(first_path);
+    remove(second_path);
+    return is_same;
+}
+
+// every thread has tournaments of its own, and the limit of games is per tournament, so the threads get the
+// same results in any order, and the system ends up the same as when the games are added from one thread
+static bool check(int threads_num, int games_num) {
+    bool is_done = true;
+    for (int index = 0; index < 2; index++) {
+        bool is_concurrent = index == 0;
+        ChessSystem chess = createSystem(threads_num);
+        Worker* workers = createWorkers(chess, NULL, threads_num, games_num);
+        bool is_run = chess != NULL && workers != NULL &&
+                      (!is_concurrent || chessSetThreadSafe(chess, true) == CHESS_SUCCESS) &&
+                      runWorkers(workers, threads_num, is_concurrent) && save(chess, threads_num, index);
+        is_done = is_done && is_run;
+        free(workers);
+        chessDestroy(chess);
+    }
+    bool is_same_levels = isSameFile(LEVELS_PATH, 0, 1);
+    bool is_same_statistics = isSameFile(STATISTICS_PATH, 0, 1);
+    printf("{\"check\":\"%s\",\"threads\":%d,\"games_per_thread\":%d,\"same_levels\":%s,\"same_statistics\":%s}\n",
+           is_done && is_same_levels && is_same_statistics ? "passed" : "failed", threads_num, games_num,
+           is_same_levels ? "true" : "false", is_same_statistics ? "true" : "false");
+    return is_done && is_same_levels && is_same_statistics;
+}
+
+int main(int argc, char** argv) {
+    bool is_check = argc > 1 && strcmp(argv[1], "check") == 0;
+    int first_number = is_check ? 2 : 1;
+    int max_threads = argc > first_number ? atoi(argv[first_number]) : DEFAULT_MAX_THREADS;
+    int games_num = argc > first_number + 1 ? atoi(argv[first_number + 1]) : DEFAULT_GAMES_PER_THREAD;
+    if (max_threads < 1 || games_num < 0) {
+        fprintf(stderr, "usage: %s [check] [threads [games_per_thread]]\n", argv[0]);
+        return 1;
+    }
+    if (is_check) {
+        return check(max_threads, games_num) ? 0 : 1;
+    }
+    bool is_done = true;
+    for (int threads_num = 1; is_done && threads_num <= max_threads; threads_num *= 2) {
+        is_done = measure(threads_num, games_num, false) && measure(threads_num, games_num, true);
+    }
+    return is_done ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+/* benchmark of chessEndTournament and chessEndTournaments on tournaments with many participants */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NUM_OF_TOURNAMENTS 10
+#define NUM_OF_PARTICIPANTS 50000
+#define GAMES_PER_PLAYER 4
+#define MAX_PLAY_TIME 3600
+
+// wall clock time, so the time of a batch that runs on several threads isn't summed over them
+static double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// every player of the tournament plays GAMES_PER_PLAYER games against the players after him in the ring
+static int fillTournament(ChessSystem chess, int tournament_id) {
+    if (chessAddTournament(chess, tournament_id, 2 * GAMES_PER_PLAYER, "Location") != CHESS_SUCCESS) {
+        return 1;
+    }
+    for (int i = 0; i < NUM_OF_PARTICIPANTS; i++) {
+        for (int distance = 1; distance <= GAMES_PER_PLAYER; distance++) {
+            int first_player = i + 1;
+            int second_player = (i + distance) % NUM_OF_PARTICIPANTS + 1;
+            if (chessAddGame(chess, tournament_id, first_player, second_player, (Winner)(rand() % 3),
+                             rand() % MAX_PLAY_TIME + 1) != CHESS_SUCCESS) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main() {
+    ChessSystem chess = chessCreate();
+    if (chess == NULL) {
+        return 1;
+    }
+    srand(NUM_OF_PARTICIPANTS);
+    for (int i = 1; i <= NUM_OF_TOURNAMENTS; i++) {
+        if (fillTournament(chess, i) != 0) {
+            chessDestroy(chess);
+            return 1;
+        }
+    }
+
+    // the first half of the tournaments are ended one by one, and the second half in one batch
+    int half = NUM_OF_TOURNAMENTS / 2;
+    double start = now();
+    for (int i = 1; i <= half; i++) {
+        if (chessEndTournament(chess, i) != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            return 1;
+        }
+    }
+    double seconds = now() - start;
+    printf("chessEndTournament, %d participants: %.1f us per tournament\n",
+           NUM_OF_PARTICIPANTS, seconds * 1e6 / half);
+
+    int batch_ids[NUM_OF_TOURNAMENTS];
+    for (int i = 0; i < NUM_OF_TOURNAMENTS - half; i++) {
+        batch_ids[i] = half + i + 1;
+    }
+    start = now();
+    if (chessEndTournaments(chess, batch_ids, NUM_OF_TOURNAMENTS - half, NULL) != CHESS_SUCCESS) {
+        chessDestroy(chess);
+        return 1;
+    }
+    seconds = now() - start;
+    printf("chessEndTournaments, %d participants: %.1f us per tournament\n",
+           NUM_OF_PARTICIPANTS, seconds * 1e6 / (NUM_OF_TOURNAMENTS - half));
+
+    chessDestroy(chess);
+    return 0;
+}
@@ -0,0 +1,66 @@
+/* benchmark of chessImportResults on a generated file of results */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NUM_OF_TOURNAMENTS 20
+#define NUM_OF_PARTICIPANTS 20000
+#define GAMES_PER_PLAYER 5
+#define MAX_PLAY_TIME 3600
+#define RESULTS_PATH "importBench.csv"
+
+static double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// every player of every tournament plays GAMES_PER_PLAYER games against the players after him in the ring.
+// returns the size of the file, or -1 if writing it failed.
+static long writeResults() {
+    FILE* file = fopen(RESULTS_PATH, "w");
+    if (file == NULL) {
+        return -1;
+    }
+    srand(NUM_OF_PARTICIPANTS);
+    for (int tournament_id = 1; tournament_id <= NUM_OF_TOURNAMENTS; tournament_id++) {
+        fprintf(file, "%d,%d,Location\n", tournament_id, 2 * GAMES_PER_PLAYER);
+        for (int i = 0; i < NUM_OF_PARTICIPANTS; i++) {
+            for (int distance = 1; distance <= GAMES_PER_PLAYER; distance++) {
+                fprintf(file, "%d,%d,%d,%d,%d\n", tournament_id, i + 1, (i + distance) % NUM_OF_PARTICIPANTS + 1,
+                        rand() % 3, rand() % MAX_PLAY_TIME + 1);
+            }
+        }
+    }
+    long size = ftell(file);
+    return fclose(file) == 0 ? size : -1;
+}
+
+int main() {
+    long size = writeResults();
+    ChessSystem chess = chessCreate();
+    if (size < 0 || chess == NULL) {
+        chessDestroy(chess);
+        remove(RESULTS_PATH);
+        return 1;
+    }
+    ChessImportReport report;
+    double start = now();
+    ChessResult result = chessImportResults(chess, RESULTS_PATH, &report);
+    double seconds = now() - start;
+    chessDestroy(chess);
+    remove(RESULTS_PATH);
+    if (result != CHESS_SUCCESS) {
+        return 1;
+    }
+    printf("chessImportResults: %d accepted, %d rejected, %.1f MB in %.1f ms, %.1f MB/s, %.0f records/s\n",
+           report.accepted, report.rejected, size / 1e6, seconds * 1e3, size / 1e6 / seconds,
+           (report.accepted + report.rejected) / seconds);
+    return 0;
+}
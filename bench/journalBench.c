@@ -0,0 +1,116 @@
+/* benchmark of chessAddGame with the journal off, and with every sync policy and a few group sizes */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define NUM_OF_PARTICIPANTS 20000
+#define GAMES_PER_PLAYER 5
+#define MAX_PLAY_TIME 3600
+// syncing every record is slow enough that it only gets a slice of the games
+#define SYNCED_RECORDS_NUM 2000
+#define JOURNAL_PATH "journalBench.log"
+
+typedef struct {
+    const char* name;
+    bool is_journaled;
+    ChessSyncPolicy sync_policy;
+    int group_size;
+    int max_games;
+} BenchCase;
+
+static double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// adds up to max_games games of a ring tournament, and returns the number added, or -1 on failure
+static int addGames(ChessSystem chess, int max_games) {
+    if (chessAddTournament(chess, 1, 2 * GAMES_PER_PLAYER, "Location") != CHESS_SUCCESS) {
+        return -1;
+    }
+    srand(NUM_OF_PARTICIPANTS);
+    int games_num = 0;
+    for (int i = 0; i < NUM_OF_PARTICIPANTS; i++) {
+        for (int distance = 1; distance <= GAMES_PER_PLAYER; distance++) {
+            if (games_num == max_games) {
+                return games_num;
+            }
+            int first_player = i + 1;
+            int second_player = (i + distance) % NUM_OF_PARTICIPANTS + 1;
+            if (chessAddGame(chess, 1, first_player, second_player, (Winner)(rand() % 3),
+                             rand() % MAX_PLAY_TIME + 1) != CHESS_SUCCESS) {
+                return -1;
+            }
+            games_num++;
+        }
+    }
+    return games_num;
+}
+
+static bool runCase(const BenchCase* bench_case) {
+    remove(JOURNAL_PATH);
+    ChessSystem chess = chessCreate();
+    if (chess == NULL || chessSetSyncPolicy(chess, bench_case->sync_policy) != CHESS_SUCCESS ||
+        (bench_case->is_journaled && chessJournalOpen(chess, JOURNAL_PATH, bench_case->group_size) != CHESS_SUCCESS)) {
+        chessDestroy(chess);
+        return false;
+    }
+    double start = now();
+    int games_num = addGames(chess, bench_case->max_games);
+    bool is_closed = chessJournalClose(chess) == CHESS_SUCCESS;
+    double seconds = now() - start;
+    chessDestroy(chess);
+    if (games_num < 0 || !is_closed) {
+        return false;
+    }
+    printf("%-30s %7d games: %9.1f ms, %10.0f games/s\n", bench_case->name, games_num, seconds * 1e3,
+           games_num / seconds);
+    return true;
+}
+
+static bool benchRecover() {
+    ChessSystem chess = chessCreate();
+    if (chess == NULL) {
+        return false;
+    }
+    ChessResult result;
+    double start = now();
+    int records_num = chessRecover(chess, JOURNAL_PATH, &result);
+    double seconds = now() - start;
+    chessDestroy(chess);
+    if (result != CHESS_SUCCESS) {
+        return false;
+    }
+    printf("%-30s %7d records: %7.1f ms\n", "chessRecover", records_num, seconds * 1e3);
+    return true;
+}
+
+int main() {
+    const int all_games = NUM_OF_PARTICIPANTS * GAMES_PER_PLAYER;
+    const BenchCase cases[] = {
+        { "no journal", false, CHESS_SYNC_NONE, 1, all_games },
+        { "CHESS_SYNC_NONE, group 1", true, CHESS_SYNC_NONE, 1, all_games },
+        { "CHESS_SYNC_NONE, group 1024", true, CHESS_SYNC_NONE, 1024, all_games },
+        { "CHESS_SYNC_ON_SAVE, group 1", true, CHESS_SYNC_ON_SAVE, 1, SYNCED_RECORDS_NUM },
+        { "CHESS_SYNC_ON_SAVE, group 64", true, CHESS_SYNC_ON_SAVE, 64, all_games },
+        { "CHESS_SYNC_ON_SAVE, group 1024", true, CHESS_SYNC_ON_SAVE, 1024, all_games },
+    };
+    for (int i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++) {
+        if (!runCase(&cases[i])) {
+            remove(JOURNAL_PATH);
+            return 1;
+        }
+    }
+    // the journal of the last case holds every game
+    bool is_recovered = benchRecover();
+    remove(JOURNAL_PATH);
+    return is_recovered ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/* time of chessSavePlayersLevels after a few changes since the last save.
+ * usage: levelsBench [players [rounds]]
+ * every player of a system plays a game, the levels are saved once, and then rounds of games are added with a
+ * save after each round, for rounds of 0, 1, 10 and so on games, each of which changes the levels of two players.
+ * the results are printed as one JSON object per number of games per round, with the time of the first save. */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "chessSystem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define DEFAULT_PLAYERS 200000
+#define DEFAULT_ROUNDS 20
+#define MAX_GAMES_PER_PLAYER 1000000
+#define MAX_PLAY_TIME 3600
+#define TOURNAMENTS_NUM 64
+#define MAX_GAMES_PER_ROUND 100000
+#define LEVELS_PATH "levelsBench.txt"
+
+// xorshift64*
+static uint64_t nextRandom(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * UINT64_C(2685821657736338717);
+}
+
+static double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// saves the levels of a system, and gives the time it took, or a negative number if it failed
+static double save(ChessSystem chess) {
+    FILE* levels = fopen(LEVELS_PATH, "w");
+    if (levels == NULL) {
+        return -1;
+    }
+    double start = now();
+    ChessResult result = chessSavePlayersLevels(chess, levels);
+    double seconds = now() - start;
+    fclose(levels);
+    return result == CHESS_SUCCESS ? seconds : -1;
+}
+
+// a system with the tournaments of the rounds, in which every player already played a game
+static ChessSystem createSystem(int players_num) {
+    ChessSystem chess = chessCreate();
+    if (chess == NULL) {
+        return NULL;
+    }
+    for (int id = 1; id <= TOURNAMENTS_NUM; id++) {
+        if (chessAddTournament(chess, id, MAX_GAMES_PER_PLAYER, "Location") != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            return NULL;
+        }
+    }
+    uint64_t random_state = UINT64_C(0x9E3779B97F4A7C15);
+    for (int player = 1; player < players_num; player += 2) {
+        chessAddGame(chess, 1, player, player + 1, (Winner)(nextRandom(&random_state) % 3), 1);
+    }
+    return chess;
+}
+
+static bool measure(int players_num, int rounds) {
+    ChessSystem chess = createSystem(players_num);
+    double first_save = chess == NULL ? -1 : save(chess);
+    if (first_save < 0) {
+        chessDestroy(chess);
+        return false;
+    }
+    uint64_t random_state = UINT64_C(0xD1B54A32D192ED03);
+    for (int games_num = 0; games_num <= MAX_GAMES_PER_ROUND; games_num = games_num == 0 ? 1 : games_num * 10) {
+        double total = 0;
+        for (int round = 0; round < rounds; round++) {
+            for (int i = 0; i < games_num; i++) {
+                int first_player = nextRandom(&random_state) % players_num + 1;
+                int second_player = nextRandom(&random_state) % players_num + 1;
+                chessAddGame(chess, nextRandom(&random_state) % TOURNAMENTS_NUM + 1, first_player, second_player,
+                             (Winner)(nextRandom(&random_state) % 3), nextRandom(&random_state) % MAX_PLAY_TIME + 1);
+            }
+            double seconds = save(chess);
+            if (seconds < 0) {
+                chessDestroy(chess);
+                return false;
+            }
+            total += seconds;
+        }
+        printf("{\"players\":%d,\"games_per_round\":%d,\"rounds\":%d,\"first_save_ms\":%.3f,\"save_ms\":%.3f}\n",
+               players_num, games_num, rounds, first_save * 1e3, total * 1e3 / rounds);
+    }
+    chessDestroy(chess);
+    remove(LEVELS_PATH);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int players_num = argc > 1 ? atoi(argv[1]) : DEFAULT_PLAYERS;
+    int rounds = argc > 2 ? atoi(argv[2]) : DEFAULT_ROUNDS;
+    if (players_num < 2 || rounds < 1) {
+        fprintf(stderr, "usage: %s [players [rounds]]\n", argv[0]);
+        return 1;
+    }
+    return measure(players_num, rounds) ? 0 : 1;
+}
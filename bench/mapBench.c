@@ -0,0 +1,97 @@
+/* micro-benchmark of the Map lookup path at growing key counts */
+
+#include "map.h"
+#include "mapExtensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define NUM_OF_SCALES 3
+#define LOOKUP_ROUNDS 5
+
+static MapDataElement intCopy(MapDataElement element) {
+    int* copy = malloc(sizeof(*copy));
+    if (copy == NULL)
+        return NULL;
+    *copy = *(int*)element;
+    return copy;
+}
+
+static void intFree(MapDataElement element) {
+    free(element);
+}
+
+static int intCompare(MapKeyElement element1, MapKeyElement element2) {
+    return *(int*)element1 - *(int*)element2;
+}
+
+// fills keys with 1..size in a random order (fixed seed so runs are comparable)
+static void shuffledKeys(int* keys, int size) {
+    for (int i = 0; i < size; i++) {
+        keys[i] = i + 1;
+    }
+    srand(size);
+    for (int i = size - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int temp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = temp;
+    }
+}
+
+static double secondsSince(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static int benchScale(int size, bool int_keyed) {
+    int* keys = malloc(sizeof(*keys)*size);
+    Map map = int_keyed ? mapCreateIntKeyed(intCopy, intFree) :
+                          mapCreate(intCopy, intCopy, intFree, intFree, intCompare);
+    if (keys == NULL || map == NULL) {
+        free(keys);
+        mapDestroy(map);
+        return 1;
+    }
+    shuffledKeys(keys, size);
+
+    clock_t start = clock();
+    for (int i = 0; i < size; i++) {
+        mapPut(map, &keys[i], &keys[i]);
+    }
+    double put_time = secondsSince(start);
+
+    long found = 0;
+    start = clock();
+    for (int round = 0; round < LOOKUP_ROUNDS; round++) {
+        for (int i = 0; i < size; i++) {
+            found += (mapGet(map, &keys[i]) != NULL);
+        }
+    }
+    double get_time = secondsSince(start);
+
+    start = clock();
+    for (int i = 0; i < size; i++) {
+        mapRemove(map, &keys[i]);
+    }
+    double remove_time = secondsSince(start);
+
+    printf("%-10s %-8d %12.1f %12.1f %12.1f %10ld\n", int_keyed ? "int" : "generic", size, put_time*1e9/size,
+           get_time*1e9/((double)size*LOOKUP_ROUNDS), remove_time*1e9/size, found);
+    mapDestroy(map);
+    free(keys);
+    return 0;
+}
+
+int main() {
+    int const scales[NUM_OF_SCALES] = { 1000, 10000, 100000 };
+    printf("%-10s %-8s %12s %12s %12s %10s\n", "map", "keys", "put ns/op", "get ns/op", "remove ns/op", "found");
+    for (int i = 0; i < NUM_OF_SCALES; i++) {
+        if (benchScale(scales[i], false) != 0 || benchScale(scales[i], true) != 0) {
+            printf("Dynamic Allocation Error");
+            return 1;
+        }
+    }
+    return 0;
+}
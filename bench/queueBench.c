@@ -0,0 +1,208 @@
+/* throughput and tail latency of adding games from several threads in bursts, directly or through the queue.
+ * usage: queueBench [max_producers [games_per_producer [burst [pause_us]]]]
+ * every producer thread adds bursts of games back to back to tournaments of its own, between players drawn
+ * from one pool shared by all producers, and pauses between the bursts, like handlers of requests that arrive
+ * in bursts. the games are either added with chessAddGame to a system made thread safe with chessSetThreadSafe,
+ * or queued with chessQueueAddGame to the thread of the queue of the system (chessStartQueue). for every game
+ * two latencies are measured: how long the producer was held up by the call, and how long it took until the
+ * game was added, which is when its callback was called for a queued game. the results are printed as one JSON
+ * object per line, for 1, 2, 4 and so on producers. */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+
+#define DEFAULT_MAX_PRODUCERS 4
+#define DEFAULT_GAMES_PER_PRODUCER 100000
+#define DEFAULT_BURST 256
+#define DEFAULT_PAUSE_US 200
+#define QUEUE_CAPACITY 4096
+#define PLAYERS_NUM 20000
+#define TOURNAMENTS_PER_PRODUCER 16
+#define MAX_GAMES_PER_PLAYER 1000
+#define MAX_PLAY_TIME 3600
+// every player plays a game in this tournament before the producers start, so the producers find every player
+#define WARM_UP_TOURNAMENT 1
+#define PRODUCERS_FIRST_TOURNAMENT 2
+
+typedef struct {
+    uint64_t start;
+    uint64_t held_up;
+    uint64_t done; // the latency until the game was added
+    ChessResult result;
+} Game;
+
+typedef struct {
+    ChessSystem chess;
+    bool is_queued;
+    int index;
+    int games_num;
+    int burst;
+    long pause_ns;
+    Game* games;
+    pthread_t thread;
+} Producer;
+
+// xorshift64*, seeded by the index of the thread, so a thread makes the same calls in every run
+static uint64_t nextRandom(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * UINT64_C(2685821657736338717);
+}
+
+static uint64_t now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000u + time.tv_nsec;
+}
+
+static void finishGame(ChessResult result, void* context) {
+    Game* game = context;
+    game->result = result;
+    game->done = now() - game->start;
+}
+
+static void* runProducer(void* context) {
+    Producer* producer = context;
+    uint64_t random_state = (producer->index + 1) * UINT64_C(0x9E3779B97F4A7C15);
+    int first_tournament = PRODUCERS_FIRST_TOURNAMENT + producer->index * TOURNAMENTS_PER_PRODUCER;
+    for (int i = 0; i < producer->games_num; i++) {
+        if (i > 0 && i % producer->burst == 0 && producer->pause_ns > 0) {
+            struct timespec pause = { producer->pause_ns / 1000000000, producer->pause_ns % 1000000000 };
+            nanosleep(&pause, NULL);
+        }
+        int first_player = nextRandom(&random_state) % PLAYERS_NUM + 1;
+        int second_player = nextRandom(&random_state) % PLAYERS_NUM + 1;
+        int tournament_id = first_tournament + nextRandom(&random_state) % TOURNAMENTS_PER_PRODUCER;
+        Winner winner = (Winner)(nextRandom(&random_state) % 3);
+        int play_time = nextRandom(&random_state) % MAX_PLAY_TIME + 1;
+        Game* game = &producer->games[i];
+        game->start = now();
+        if (producer->is_queued) {
+            chessQueueAddGame(producer->chess, tournament_id, first_player, second_player, winner, play_time,
+                              finishGame, game);
+        } else {
+            finishGame(chessAddGame(producer->chess, tournament_id, first_player, second_player, winner,
+                                    play_time), game);
+        }
+        game->held_up = now() - game->start;
+    }
+    return NULL;
+}
+
+// a system with the tournaments of every producer, in which every player already played a game
+static ChessSystem createSystem(int producers_num) {
+    ChessSystem chess = chessCreate();
+    if (chess == NULL) {
+        return NULL;
+    }
+    int tournaments_num = PRODUCERS_FIRST_TOURNAMENT + producers_num * TOURNAMENTS_PER_PRODUCER;
+    for (int id = WARM_UP_TOURNAMENT; id < tournaments_num; id++) {
+        if (chessAddTournament(chess, id, MAX_GAMES_PER_PLAYER, "Location") != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            return NULL;
+        }
+    }
+    for (int player = 1; player < PLAYERS_NUM; player += 2) {
+        chessAddGame(chess, WARM_UP_TOURNAMENT, player, player + 1, DRAW, 1);
+    }
+    return chess;
+}
+
+static int compareLatencies(const void* first, const void* second) {
+    uint64_t a = *(const uint64_t*)first, b = *(const uint64_t*)second;
+    return (a > b) - (a < b);
+}
+
+// prints the percentiles of the latencies, in microseconds, sorting them in place
+static void printLatencies(const char* name, uint64_t* latencies, long count) {
+    static const double percentiles[] = { 0.5, 0.99, 0.999 };
+    static const char* const percentile_names[] = { "p50", "p99", "p999" };
+    qsort(latencies, count, sizeof(*latencies), compareLatencies);
+    for (int i = 0; i < (int)(sizeof(percentiles) / sizeof(percentiles[0])); i++) {
+        printf(",\"%s_%s_us\":%.1f", name, percentile_names[i], latencies[(long)(percentiles[i] * (count - 1))] / 1e3);
+    }
+    printf(",\"%s_max_us\":%.1f", name, latencies[count - 1] / 1e3);
+}
+
+static bool measure(int producers_num, int games_num, int burst, long pause_ns, bool is_queued) {
+    ChessSystem chess = createSystem(producers_num);
+    long count = (long)producers_num * games_num;
+    Producer* producers = calloc(producers_num, sizeof(*producers));
+    Game* games = calloc(count > 0 ? count : 1, sizeof(*games));
+    uint64_t* latencies = malloc(sizeof(*latencies) * (count > 0 ? count : 1));
+    bool is_done = chess != NULL && producers != NULL && games != NULL && latencies != NULL &&
+                   (is_queued ? chessStartQueue(chess, QUEUE_CAPACITY) : chessSetThreadSafe(chess, true)) ==
+                   CHESS_SUCCESS;
+    int started = 0;
+    uint64_t start = now();
+    while (is_done && started < producers_num) {
+        Producer* producer = &producers[started];
+        *producer = (Producer){ chess, is_queued, started, games_num, burst, pause_ns,
+                                games + (long)started * games_num };
+        if (pthread_create(&producer->thread, NULL, runProducer, producer) != 0) {
+            fprintf(stderr, "couldn't start %d threads\n", producers_num);
+            is_done = false;
+            break;
+        }
+        started++;
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(producers[i].thread, NULL);
+    }
+    if (chess != NULL) {
+        chessFlushQueue(chess);
+    }
+    double seconds = (now() - start) / 1e9;
+    if (is_done && count > 0) {
+        long failures = 0;
+        for (long i = 0; i < count; i++) {
+            failures += games[i].result != CHESS_SUCCESS;
+        }
+        printf("{\"mode\":\"%s\",\"producers\":%d,\"games\":%ld,\"burst\":%d,\"pause_us\":%ld,\"failed_games\":%ld,"
+               "\"seconds\":%.3f,\"games_per_second\":%.0f", is_queued ? "queued" : "direct", producers_num, count,
+               burst, pause_ns / 1000, failures, seconds, count / seconds);
+        for (long i = 0; i < count; i++) {
+            latencies[i] = games[i].held_up;
+        }
+        printLatencies("held_up", latencies, count);
+        for (long i = 0; i < count; i++) {
+            latencies[i] = games[i].done;
+        }
+        printLatencies("done", latencies, count);
+        printf("}\n");
+    }
+    chessDestroy(chess);
+    free(latencies);
+    free(games);
+    free(producers);
+    return is_done;
+}
+
+int main(int argc, char** argv) {
+    int max_producers = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_PRODUCERS;
+    int games_num = argc > 2 ? atoi(argv[2]) : DEFAULT_GAMES_PER_PRODUCER;
+    int burst = argc > 3 ? atoi(argv[3]) : DEFAULT_BURST;
+    long pause_ns = (argc > 4 ? atol(argv[4]) : DEFAULT_PAUSE_US) * 1000;
+    if (max_producers < 1 || games_num < 0 || burst < 1 || pause_ns < 0) {
+        fprintf(stderr, "usage: %s [max_producers [games_per_producer [burst [pause_us]]]]\n", argv[0]);
+        return 1;
+    }
+    bool is_done = true;
+    for (int producers_num = 1; is_done && producers_num <= max_producers; producers_num *= 2) {
+        is_done = measure(producers_num, games_num, burst, pause_ns, false) &&
+                  measure(producers_num, games_num, burst, pause_ns, true);
+    }
+    return is_done ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+/* throughput of reading the results of players while a thread adds their games.
+ * usage: readBench [max_readers [seconds]]
+ * one writer thread adds games between players drawn from a shared pool, and the reader threads ask for the
+ * average play time and the level of players drawn from the same pool, for a fixed time. the calls run either
+ * behind one global mutex, the way a system that isn't thread safe has to be shared, or on a system made thread
+ * safe with chessSetThreadSafe, where the readers don't lock the players they read. every game takes the same
+ * time, so a reader that saw the results of a player half changed would get another average, and such reads are
+ * counted. the results are printed as one JSON object per line, for 1, 2, 4 and so on readers. */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+
+#define DEFAULT_MAX_READERS 8
+#define DEFAULT_SECONDS 1.0
+#define PLAYERS_NUM 10000
+#define TOURNAMENTS_NUM 64
+#define MAX_GAMES_PER_PLAYER 1000000
+#define PLAY_TIME 60
+#define MIN_LEVEL -10
+#define MAX_LEVEL 6
+// every player plays a game in this tournament before the threads start, so the threads find every player
+#define WARM_UP_TOURNAMENT 1
+#define WRITER_FIRST_TOURNAMENT 2
+// the threads look at the clock once in this many calls
+#define CALLS_PER_CHECK 256
+
+typedef struct {
+    ChessSystem chess;
+    pthread_mutex_t* mutex; // NULL if the system is thread safe
+    const bool* is_stopped;
+    int index;
+    long calls;
+    long failures;
+    long inconsistent_reads;
+    pthread_t thread;
+} Worker;
+
+// xorshift64*, seeded by the index of the thread
+static uint64_t nextRandom(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * UINT64_C(2685821657736338717);
+}
+
+static double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+static void lock(Worker* worker) {
+    if (worker->mutex != NULL) {
+        pthread_mutex_lock(worker->mutex);
+    }
+}
+
+static void unlock(Worker* worker) {
+    if (worker->mutex != NULL) {
+        pthread_mutex_unlock(worker->mutex);
+    }
+}
+
+static bool isStopped(Worker* worker) {
+    return __atomic_load_n(worker->is_stopped, __ATOMIC_RELAXED);
+}
+
+static void* runWriter(void* context) {
+    Worker* worker = context;
+    uint64_t random_state = UINT64_C(0x9E3779B97F4A7C15);
+    while (!isStopped(worker)) {
+        for (int i = 0; i < CALLS_PER_CHECK; i++) {
+            int first_player = nextRandom(&random_state) % PLAYERS_NUM + 1;
+            int second_player = nextRandom(&random_state) % PLAYERS_NUM + 1;
+            int tournament_id = WRITER_FIRST_TOURNAMENT + nextRandom(&random_state) % TOURNAMENTS_NUM;
+            Winner winner = (Winner)(nextRandom(&random_state) % 3);
+            lock(worker);
+            ChessResult result = chessAddGame(worker->chess, tournament_id, first_player, second_player, winner,
+                                              PLAY_TIME);
+            unlock(worker);
+            worker->failures += result != CHESS_SUCCESS;
+        }
+        worker->calls += CALLS_PER_CHECK;
+    }
+    return NULL;
+}
+
+static void* runReader(void* context) {
+    Worker* worker = context;
+    uint64_t random_state = (worker->index + 2) * UINT64_C(0x9E3779B97F4A7C15);
+    while (!isStopped(worker)) {
+        for (int i = 0; i < CALLS_PER_CHECK; i++) {
+            int player = nextRandom(&random_state) % PLAYERS_NUM + 1;
+            ChessResult result;
+            bool is_consistent;
+            lock(worker);
+            if (i % 2 == 0) {
+                is_consistent = chessCalculateAveragePlayTime(worker->chess, player, &result) == PLAY_TIME;
+            } else {
+                double level = chessGetPlayerLevel(worker->chess, player, &result);
+                is_consistent = level >= MIN_LEVEL && level <= MAX_LEVEL;
+            }
+            unlock(worker);
+            worker->failures += result != CHESS_SUCCESS;
+            worker->inconsistent_reads += !is_consistent;
+        }
+        worker->calls += CALLS_PER_CHECK;
+    }
+    return NULL;
+}
+
+// a system with the tournaments of the writer, in which every player already played a game
+static ChessSystem createSystem() {
+    ChessSystem chess = chessCreate();
+    if (chess == NULL) {
+        return NULL;
+    }
+    for (int id = WARM_UP_TOURNAMENT; id < WRITER_FIRST_TOURNAMENT + TOURNAMENTS_NUM; id++) {
+        if (chessAddTournament(chess, id, MAX_GAMES_PER_PLAYER, "Location") != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            return NULL;
+        }
+    }
+    for (int player = 1; player < PLAYERS_NUM; player += 2) {
+        chessAddGame(chess, WARM_UP_TOURNAMENT, player, player + 1, DRAW, PLAY_TIME);
+    }
+    return chess;
+}
+
+// runs the writer as the first worker and the readers as the others, until the time is up
+static bool runWorkers(Worker* workers, int workers_num, bool* is_stopped, double seconds) {
+    int started = 0;
+    while (started < workers_num && pthread_create(&workers[started].thread, NULL,
+                                                   started == 0 ? runWriter : runReader, &workers[started]) == 0) {
+        started++;
+    }
+    if (started == workers_num) {
+        struct timespec duration = { (time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9) };
+        nanosleep(&duration, NULL);
+    }
+    __atomic_store_n(is_stopped, true, __ATOMIC_RELAXED);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    if (started < workers_num) {
+        fprintf(stderr, "couldn't start %d threads\n", workers_num);
+        return false;
+    }
+    return true;
+}
+
+static bool measure(int readers_num, double seconds, bool is_thread_safe) {
+    ChessSystem chess = createSystem();
+    pthread_mutex_t mutex;
+    pthread_mutex_init(&mutex, NULL);
+    bool is_stopped = false;
+    int workers_num = readers_num + 1;
+    Worker* workers = calloc(workers_num, sizeof(*workers));
+    for (int i = 0; workers != NULL && i < workers_num; i++) {
+        workers[i].chess = chess;
+        workers[i].mutex = is_thread_safe ? NULL : &mutex;
+        workers[i].is_stopped = &is_stopped;
+        workers[i].index = i;
+    }
+    bool is_done = chess != NULL && workers != NULL &&
+                   (!is_thread_safe || chessSetThreadSafe(chess, true) == CHESS_SUCCESS);
+    double start = now();
+    is_done = is_done && runWorkers(workers, workers_num, &is_stopped, seconds);
+    double elapsed = now() - start;
+    if (is_done) {
+        long reads = 0, failures = workers[0].failures, inconsistent_reads = 0;
+        for (int i = 1; i < workers_num; i++) {
+            reads += workers[i].calls;
+            failures += workers[i].failures;
+            inconsistent_reads += workers[i].inconsistent_reads;
+        }
+        printf("{\"mode\":\"%s\",\"readers\":%d,\"seconds\":%.3f,\"reads_per_second\":%.0f,"
+               "\"games_per_second\":%.0f,\"failed_calls\":%ld,\"inconsistent_reads\":%ld}\n",
+               is_thread_safe ? "thread_safe" : "global_mutex", readers_num, elapsed, reads / elapsed,
+               workers[0].calls / elapsed, failures, inconsistent_reads);
+    }
+    free(workers);
+    pthread_mutex_destroy(&mutex);
+    chessDestroy(chess);
+    return is_done;
+}
+
+int main(int argc, char** argv) {
+    int max_readers = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_READERS;
+    double seconds = argc > 2 ? atof(argv[2]) : DEFAULT_SECONDS;
+    if (max_readers < 1 || seconds <= 0) {
+        fprintf(stderr, "usage: %s [max_readers [seconds]]\n", argv[0]);
+        return 1;
+    }
+    bool is_done = true;
+    for (int readers_num = 1; is_done && readers_num <= max_readers; readers_num *= 2) {
+        is_done = measure(readers_num, seconds, false) && measure(readers_num, seconds, true);
+    }
+    return is_done ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+/* benchmark of chessRemovePlayer: removes a part of the players of a system that holds many games */
+
+#include "chessSystem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NUM_OF_TOURNAMENTS 10
+#define NUM_OF_PLAYERS 5000
+#define NUM_OF_GAMES 100000
+#define NUM_OF_REMOVED 1000
+#define MAX_GAMES_FOR_PLAYER 1000
+#define MAX_PLAY_TIME 3600
+
+static double secondsSince(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// adds NUM_OF_GAMES games between random players, spread over all the tournaments
+static int fillSystem(ChessSystem chess) {
+    for (int i = 1; i <= NUM_OF_TOURNAMENTS; i++) {
+        if (chessAddTournament(chess, i, MAX_GAMES_FOR_PLAYER, "Location") != CHESS_SUCCESS) {
+            return 1;
+        }
+    }
+    int games = 0;
+    while (games < NUM_OF_GAMES) {
+        int first_player = rand() % NUM_OF_PLAYERS + 1;
+        int second_player = rand() % NUM_OF_PLAYERS + 1;
+        if (first_player == second_player) {
+            continue;
+        }
+        ChessResult result = chessAddGame(chess, games % NUM_OF_TOURNAMENTS + 1, first_player, second_player,
+                                          (Winner)(rand() % 3), rand() % MAX_PLAY_TIME + 1);
+        if (result == CHESS_SUCCESS) {
+            games++;
+        }
+        else if (result != CHESS_GAME_ALREADY_EXISTS) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main() {
+    ChessSystem chess = chessCreate();
+    if (chess == NULL) {
+        return 1;
+    }
+    srand(NUM_OF_GAMES);
+    if (fillSystem(chess) != 0) {
+        chessDestroy(chess);
+        return 1;
+    }
+
+    clock_t start = clock();
+    int removed = 0;
+    for (int player_id = 1; removed < NUM_OF_REMOVED; player_id += NUM_OF_PLAYERS / NUM_OF_REMOVED) {
+        if (chessRemovePlayer(chess, player_id) != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            return 1;
+        }
+        removed++;
+    }
+    double seconds = secondsSince(start);
+    printf("removed %d of %d players holding %d games: %.3f s total, %.1f us per player\n",
+           NUM_OF_REMOVED, NUM_OF_PLAYERS, NUM_OF_GAMES, seconds, seconds * 1e6 / NUM_OF_REMOVED);
+
+    chessDestroy(chess);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/* benchmark of chessLoadSnapshot against adding all the games of a system again */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NUM_OF_TOURNAMENTS 20
+#define NUM_OF_PARTICIPANTS 20000
+#define GAMES_PER_PLAYER 5
+#define MAX_PLAY_TIME 3600
+#define SNAPSHOT_PATH "snapshotBench.bin"
+
+static double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// every player of every tournament plays GAMES_PER_PLAYER games against the players after him in the ring
+static ChessSystem buildSystem() {
+    ChessSystem chess = chessCreate();
+    if (chess == NULL) {
+        return NULL;
+    }
+    srand(NUM_OF_PARTICIPANTS);
+    for (int tournament_id = 1; tournament_id <= NUM_OF_TOURNAMENTS; tournament_id++) {
+        if (chessAddTournament(chess, tournament_id, 2 * GAMES_PER_PLAYER, "Location") != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            return NULL;
+        }
+        for (int i = 0; i < NUM_OF_PARTICIPANTS; i++) {
+            for (int distance = 1; distance <= GAMES_PER_PLAYER; distance++) {
+                int first_player = i + 1;
+                int second_player = (i + distance) % NUM_OF_PARTICIPANTS + 1;
+                if (chessAddGame(chess, tournament_id, first_player, second_player, (Winner)(rand() % 3),
+                                 rand() % MAX_PLAY_TIME + 1) != CHESS_SUCCESS) {
+                    chessDestroy(chess);
+                    return NULL;
+                }
+            }
+        }
+        // half of the tournaments are over, so their winners are restored too
+        if (tournament_id % 2 == 0 && chessEndTournament(chess, tournament_id) != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            return NULL;
+        }
+    }
+    return chess;
+}
+
+int main() {
+    double start = now();
+    ChessSystem chess = buildSystem();
+    if (chess == NULL) {
+        return 1;
+    }
+    double seconds = now() - start;
+    printf("adding %d games: %.1f ms\n", NUM_OF_TOURNAMENTS * NUM_OF_PARTICIPANTS * GAMES_PER_PLAYER, seconds * 1e3);
+
+    start = now();
+    if (chessSaveSnapshot(chess, SNAPSHOT_PATH) != CHESS_SUCCESS) {
+        chessDestroy(chess);
+        return 1;
+    }
+    seconds = now() - start;
+    printf("chessSaveSnapshot: %.1f ms\n", seconds * 1e3);
+    chessDestroy(chess);
+
+    start = now();
+    ChessResult result;
+    chess = chessLoadSnapshot(SNAPSHOT_PATH, &result);
+    if (chess == NULL) {
+        remove(SNAPSHOT_PATH);
+        return 1;
+    }
+    seconds = now() - start;
+    printf("chessLoadSnapshot: %.1f ms\n", seconds * 1e3);
+
+    chessDestroy(chess);
+    remove(SNAPSHOT_PATH);
+    return 0;
+}
@@ -0,0 +1,224 @@
+/* how long exports of the reports hold up a thread that adds games, with and without views.
+ * usage: viewBench [seconds [ended_tournaments]]
+ * one writer thread adds games between players drawn from a shared pool to a system made thread safe with
+ * chessSetThreadSafe, while a reporter thread saves the levels of the players and the statistics of the ended
+ * tournaments back to back. the reports are saved either with chessSavePlayersLevels and
+ * chessSaveTournamentStatistics, which hold the whole system while they print, or from a view taken with
+ * chessViewCreate, which only holds the system while it's taken. the latencies of the games are measured, and
+ * the results are printed as one JSON object per mode. */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+
+#define DEFAULT_SECONDS 1.0
+#define DEFAULT_ENDED_TOURNAMENTS 1000
+#define PLAYERS_NUM 20000
+#define TOURNAMENTS_NUM 64
+#define MAX_GAMES_PER_PLAYER 1000000
+#define MAX_PLAY_TIME 3600
+// every player plays a game in this tournament before the threads start, so the threads find every player
+#define WARM_UP_TOURNAMENT 1
+#define WRITER_FIRST_TOURNAMENT 2
+#define ENDED_FIRST_TOURNAMENT (WRITER_FIRST_TOURNAMENT + TOURNAMENTS_NUM)
+#define GAMES_PER_ENDED_TOURNAMENT 16
+#define MAX_LATENCIES (1 << 22)
+#define LEVELS_PATH "viewBenchLevels.txt"
+#define STATISTICS_PATH "viewBenchStatistics.txt"
+
+typedef struct {
+    ChessSystem chess;
+    bool is_viewed;
+    const bool* is_stopped;
+    long calls;
+    long failures;
+    uint64_t* latencies; // of the games of the writer, or of the exports of the reporter
+    pthread_t thread;
+} Worker;
+
+// xorshift64*
+static uint64_t nextRandom(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * UINT64_C(2685821657736338717);
+}
+
+static uint64_t now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000u + time.tv_nsec;
+}
+
+static bool isStopped(Worker* worker) {
+    return __atomic_load_n(worker->is_stopped, __ATOMIC_RELAXED);
+}
+
+static void* runWriter(void* context) {
+    Worker* worker = context;
+    uint64_t random_state = UINT64_C(0x9E3779B97F4A7C15);
+    while (!isStopped(worker) && worker->calls < MAX_LATENCIES) {
+        int first_player = nextRandom(&random_state) % PLAYERS_NUM + 1;
+        int second_player = nextRandom(&random_state) % PLAYERS_NUM + 1;
+        int tournament_id = WRITER_FIRST_TOURNAMENT + nextRandom(&random_state) % TOURNAMENTS_NUM;
+        Winner winner = (Winner)(nextRandom(&random_state) % 3);
+        int play_time = nextRandom(&random_state) % MAX_PLAY_TIME + 1;
+        uint64_t start = now();
+        ChessResult result = chessAddGame(worker->chess, tournament_id, first_player, second_player, winner,
+                                          play_time);
+        worker->latencies[worker->calls++] = now() - start;
+        worker->failures += result != CHESS_SUCCESS;
+    }
+    return NULL;
+}
+
+static bool export(Worker* worker) {
+    FILE* levels = fopen(LEVELS_PATH, "w");
+    if (levels == NULL) {
+        return false;
+    }
+    bool is_saved;
+    if (worker->is_viewed) {
+        ChessResult result;
+        ChessView view = chessViewCreate(worker->chess, &result);
+        is_saved = result == CHESS_SUCCESS && chessViewSavePlayersLevels(view, levels) == CHESS_SUCCESS &&
+                   chessViewSaveTournamentStatistics(view, STATISTICS_PATH) == CHESS_SUCCESS;
+        chessViewDestroy(view);
+    } else {
+        is_saved = chessSavePlayersLevels(worker->chess, levels) == CHESS_SUCCESS &&
+                   chessSaveTournamentStatistics(worker->chess, STATISTICS_PATH) == CHESS_SUCCESS;
+    }
+    fclose(levels);
+    return is_saved;
+}
+
+static void* runReporter(void* context) {
+    Worker* worker = context;
+    while (!isStopped(worker) && worker->calls < MAX_LATENCIES) {
+        uint64_t start = now();
+        worker->failures += !export(worker);
+        worker->latencies[worker->calls++] = now() - start;
+    }
+    return NULL;
+}
+
+// a system with the tournaments of the writer, in which every player already played a game, and with
+// tournaments that already ended
+static ChessSystem createSystem(int ended_tournaments) {
+    ChessSystem chess = chessCreate();
+    if (chess == NULL) {
+        return NULL;
+    }
+    for (int id = WARM_UP_TOURNAMENT; id < ENDED_FIRST_TOURNAMENT + ended_tournaments; id++) {
+        if (chessAddTournament(chess, id, MAX_GAMES_PER_PLAYER, "Location") != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            return NULL;
+        }
+    }
+    for (int player = 1; player < PLAYERS_NUM; player += 2) {
+        chessAddGame(chess, WARM_UP_TOURNAMENT, player, player + 1, DRAW, 1);
+    }
+    uint64_t random_state = UINT64_C(0xD1B54A32D192ED03);
+    for (int id = ENDED_FIRST_TOURNAMENT; id < ENDED_FIRST_TOURNAMENT + ended_tournaments; id++) {
+        for (int i = 0; i < GAMES_PER_ENDED_TOURNAMENT; i++) {
+            int first_player = nextRandom(&random_state) % PLAYERS_NUM + 1;
+            int second_player = nextRandom(&random_state) % PLAYERS_NUM + 1;
+            chessAddGame(chess, id, first_player, second_player, (Winner)(nextRandom(&random_state) % 3),
+                         nextRandom(&random_state) % MAX_PLAY_TIME + 1);
+        }
+        chessEndTournament(chess, id);
+    }
+    return chess;
+}
+
+static int compareLatencies(const void* first, const void* second) {
+    uint64_t a = *(const uint64_t*)first, b = *(const uint64_t*)second;
+    return (a > b) - (a < b);
+}
+
+// prints the percentiles of the latencies, in microseconds, sorting them in place
+static void printLatencies(const char* name, uint64_t* latencies, long count) {
+    static const double percentiles[] = { 0.5, 0.99, 0.999 };
+    static const char* const percentile_names[] = { "p50", "p99", "p999" };
+    if (count == 0) {
+        return;
+    }
+    qsort(latencies, count, sizeof(*latencies), compareLatencies);
+    for (int i = 0; i < (int)(sizeof(percentiles) / sizeof(percentiles[0])); i++) {
+        printf(",\"%s_%s_us\":%.1f", name, percentile_names[i], latencies[(long)(percentiles[i] * (count - 1))] / 1e3);
+    }
+    printf(",\"%s_max_us\":%.1f", name, latencies[count - 1] / 1e3);
+}
+
+// runs the writer as the first worker and the reporter as the second, until the time is up
+static bool runWorkers(Worker* workers, bool* is_stopped, double seconds) {
+    int started = 0;
+    while (started < 2 && pthread_create(&workers[started].thread, NULL, started == 0 ? runWriter : runReporter,
+                                         &workers[started]) == 0) {
+        started++;
+    }
+    if (started == 2) {
+        struct timespec duration = { (time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9) };
+        nanosleep(&duration, NULL);
+    }
+    __atomic_store_n(is_stopped, true, __ATOMIC_RELAXED);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    if (started < 2) {
+        fprintf(stderr, "couldn't start the threads\n");
+        return false;
+    }
+    return true;
+}
+
+static bool measure(double seconds, int ended_tournaments, bool is_viewed) {
+    ChessSystem chess = createSystem(ended_tournaments);
+    bool is_stopped = false;
+    Worker workers[2];
+    for (int i = 0; i < 2; i++) {
+        workers[i] = (Worker){ chess, is_viewed, &is_stopped, 0, 0, malloc(sizeof(uint64_t) * MAX_LATENCIES) };
+    }
+    bool is_done = chess != NULL && workers[0].latencies != NULL && workers[1].latencies != NULL &&
+                   chessSetThreadSafe(chess, true) == CHESS_SUCCESS;
+    uint64_t start = now();
+    is_done = is_done && runWorkers(workers, &is_stopped, seconds);
+    double elapsed = (now() - start) / 1e9;
+    if (is_done) {
+        printf("{\"mode\":\"%s\",\"ended_tournaments\":%d,\"seconds\":%.3f,\"games_per_second\":%.0f,"
+               "\"exports_per_second\":%.1f,\"failed_calls\":%ld", is_viewed ? "view" : "locked",
+               ended_tournaments, elapsed, workers[0].calls / elapsed, workers[1].calls / elapsed,
+               workers[0].failures + workers[1].failures);
+        printLatencies("game", workers[0].latencies, workers[0].calls);
+        printLatencies("export", workers[1].latencies, workers[1].calls);
+        printf("}\n");
+    }
+    for (int i = 0; i < 2; i++) {
+        free(workers[i].latencies);
+    }
+    chessDestroy(chess);
+    remove(LEVELS_PATH);
+    remove(STATISTICS_PATH);
+    return is_done;
+}
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : DEFAULT_SECONDS;
+    int ended_tournaments = argc > 2 ? atoi(argv[2]) : DEFAULT_ENDED_TOURNAMENTS;
+    if (seconds <= 0 || ended_tournaments < 1) {
+        fprintf(stderr, "usage: %s [seconds [ended_tournaments]]\n", argv[0]);
+        return 1;
+    }
+    bool is_done = measure(seconds, ended_tournaments, false) && measure(seconds, ended_tournaments, true);
+    return is_done ? 0 : 1;
+}
@@ -0,0 +1,276 @@
+/* seeded synthetic workload over the chess system API, timing every call.
+ * usage: workloadBench [seed [remove_ratio [end_ratio]]]
+ * the ratios are the fractions of the operations that remove a player and that end a tournament, and the rest
+ * add games. players are picked with a power law, so a few play most games like in real results.
+ * the results are printed as one JSON object per line: the latency percentiles of every function at every scale,
+ * and the number of allocations made inside its calls, counted by wrapping malloc, calloc and realloc at link time
+ * (-Wl,--wrap, see the makefile). */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_SEED 1
+#define DEFAULT_REMOVE_RATIO 0.002
+#define DEFAULT_END_RATIO 0.0005
+#define PLAYERS_PER_TOURNAMENT 50
+#define OPERATIONS_PER_PLAYER 10
+#define MAX_GAMES_PER_PLAYER 64
+#define MAX_PLAY_TIME 3600
+#define SAVES_NUM 20
+#define LEVELS_PATH "workloadBenchLevels.txt"
+#define STATISTICS_PATH "workloadBenchStatistics.txt"
+
+static const int scales[] = { 1000, 10000, 100000 };
+
+// allocations made by the process, counted by the wrappers the linker puts in place of the allocation functions
+static unsigned long allocations = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    allocations++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    allocations++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+    allocations++;
+    return __real_realloc(pointer, size);
+}
+
+typedef enum {
+    OPERATION_ADD_GAME,
+    OPERATION_REMOVE_PLAYER,
+    OPERATION_END_TOURNAMENT,
+    OPERATION_SAVE_PLAYERS_LEVELS,
+    OPERATION_SAVE_TOURNAMENT_STATISTICS,
+    OPERATIONS_NUM
+} Operation;
+
+static const char* const operation_names[OPERATIONS_NUM] = {
+    "chessAddGame", "chessRemovePlayer", "chessEndTournament", "chessSavePlayersLevels",
+    "chessSaveTournamentStatistics"
+};
+
+// the latencies of the calls of one function, and the allocations made inside them
+typedef struct {
+    uint64_t* latencies;
+    int count;
+    int capacity;
+    int failures;
+    unsigned long allocations;
+} Samples;
+
+typedef struct {
+    uint64_t random_state;
+    double remove_ratio;
+    double end_ratio;
+    int players_num;
+    int* open_tournaments;
+    int open_tournaments_num;
+    int next_tournament_id;
+    Samples samples[OPERATIONS_NUM];
+} Workload;
+
+// xorshift64*, so a seed gives the same workload with any C library
+static uint64_t nextRandom(Workload* workload) {
+    uint64_t x = workload->random_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    workload->random_state = x;
+    return x * UINT64_C(2685821657736338717);
+}
+
+static double nextUniform(Workload* workload) {
+    return (nextRandom(workload) >> 11) * (1.0 / (UINT64_C(1) << 53));
+}
+
+// player ids are drawn with density proportional to id^(-2/3), so the lowest ids are the most active players
+static int nextPlayer(Workload* workload) {
+    double u = nextUniform(workload);
+    return (int)(workload->players_num * u * u * u) + 1;
+}
+
+static uint64_t now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000u + time.tv_nsec;
+}
+
+static bool addSample(Samples* samples, uint64_t latency, bool is_failure, unsigned long call_allocations) {
+    if (samples->count == samples->capacity) {
+        int capacity = samples->capacity == 0 ? 1024 : 2 * samples->capacity;
+        uint64_t* latencies = realloc(samples->latencies, sizeof(*latencies) * capacity);
+        if (latencies == NULL) {
+            return false;
+        }
+        samples->latencies = latencies;
+        samples->capacity = capacity;
+    }
+    samples->latencies[samples->count++] = latency;
+    samples->failures += is_failure;
+    samples->allocations += call_allocations;
+    return true;
+}
+
+// the call is made between the two readings of the clock and of the allocation counter
+#define TIMED_CALL(workload, operation, call) do { \
+        unsigned long allocations_before = allocations; \
+        uint64_t start = now(); \
+        ChessResult timed_result = (call); \
+        uint64_t latency = now() - start; \
+        if (!addSample(&(workload)->samples[operation], latency, timed_result != CHESS_SUCCESS, \
+                       allocations - allocations_before)) { \
+            return false; \
+        } \
+    } while (0)
+
+static bool openTournament(ChessSystem chess, Workload* workload, int index) {
+    int tournament_id = workload->next_tournament_id++;
+    if (chessAddTournament(chess, tournament_id, MAX_GAMES_PER_PLAYER, "Location") != CHESS_SUCCESS) {
+        return false;
+    }
+    workload->open_tournaments[index] = tournament_id;
+    return true;
+}
+
+static bool runOperation(ChessSystem chess, Workload* workload) {
+    double kind = nextUniform(workload);
+    int index = nextRandom(workload) % workload->open_tournaments_num;
+    if (kind < workload->remove_ratio) {
+        int player_id = nextPlayer(workload);
+        TIMED_CALL(workload, OPERATION_REMOVE_PLAYER, chessRemovePlayer(chess, player_id));
+    }
+    else if (kind < workload->remove_ratio + workload->end_ratio) {
+        // an ended tournament is replaced by a new one, so games keep coming to the same number of tournaments
+        int tournament_id = workload->open_tournaments[index];
+        TIMED_CALL(workload, OPERATION_END_TOURNAMENT, chessEndTournament(chess, tournament_id));
+        return openTournament(chess, workload, index);
+    }
+    else {
+        int first_player = nextPlayer(workload);
+        int second_player = nextPlayer(workload);
+        if (second_player == first_player) {
+            second_player = first_player % workload->players_num + 1;
+        }
+        Winner winner = (Winner)(nextRandom(workload) % 3);
+        int play_time = nextRandom(workload) % MAX_PLAY_TIME + 1;
+        TIMED_CALL(workload, OPERATION_ADD_GAME, chessAddGame(chess, workload->open_tournaments[index],
+                                                              first_player, second_player, winner, play_time));
+    }
+    return true;
+}
+
+static ChessResult saveLevels(ChessSystem chess) {
+    FILE* file = fopen(LEVELS_PATH, "w");
+    if (file == NULL) {
+        return CHESS_SAVE_FAILURE;
+    }
+    ChessResult result = chessSavePlayersLevels(chess, file);
+    fclose(file);
+    return result;
+}
+
+static bool runSaves(ChessSystem chess, Workload* workload) {
+    for (int i = 0; i < SAVES_NUM; i++) {
+        TIMED_CALL(workload, OPERATION_SAVE_PLAYERS_LEVELS, saveLevels(chess));
+        TIMED_CALL(workload, OPERATION_SAVE_TOURNAMENT_STATISTICS,
+                   chessSaveTournamentStatistics(chess, STATISTICS_PATH));
+    }
+    return true;
+}
+
+static int compareLatencies(const void* first, const void* second) {
+    uint64_t first_latency = *(const uint64_t*)first, second_latency = *(const uint64_t*)second;
+    return (first_latency > second_latency) - (first_latency < second_latency);
+}
+
+static uint64_t percentile(const Samples* samples, double fraction) {
+    int index = (int)(fraction * (samples->count - 1) + 0.5);
+    return samples->latencies[index];
+}
+
+static void printSamples(const Workload* workload, unsigned long seed, Operation operation, Samples* samples) {
+    if (samples->count == 0) {
+        return;
+    }
+    qsort(samples->latencies, samples->count, sizeof(*samples->latencies), compareLatencies);
+    double total = 0;
+    for (int i = 0; i < samples->count; i++) {
+        total += samples->latencies[i];
+    }
+    printf("{\"seed\":%lu,\"players\":%d,\"remove_ratio\":%g,\"end_ratio\":%g,\"function\":\"%s\","
+           "\"calls\":%d,\"failures\":%d,\"mean_ns\":%.0f,\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,"
+           "\"p999_ns\":%llu,\"max_ns\":%llu,\"allocations\":%lu,\"allocations_per_call\":%.3f}\n",
+           seed, workload->players_num, workload->remove_ratio, workload->end_ratio, operation_names[operation],
+           samples->count, samples->failures, total / samples->count,
+           (unsigned long long)percentile(samples, 0.5), (unsigned long long)percentile(samples, 0.9),
+           (unsigned long long)percentile(samples, 0.99), (unsigned long long)percentile(samples, 0.999),
+           (unsigned long long)samples->latencies[samples->count - 1], samples->allocations,
+           (double)samples->allocations / samples->count);
+}
+
+static bool runScale(unsigned long seed, double remove_ratio, double end_ratio, int players_num) {
+    Workload workload;
+    memset(&workload, 0, sizeof(workload));
+    // xorshift needs a state that isn't zero
+    workload.random_state = seed * UINT64_C(0x9E3779B97F4A7C15) + 1;
+    workload.remove_ratio = remove_ratio;
+    workload.end_ratio = end_ratio;
+    workload.players_num = players_num;
+    workload.open_tournaments_num = players_num / PLAYERS_PER_TOURNAMENT;
+    workload.next_tournament_id = 1;
+    workload.open_tournaments = malloc(sizeof(int) * workload.open_tournaments_num);
+    ChessSystem chess = chessCreate();
+    bool is_done = workload.open_tournaments != NULL && chess != NULL;
+    for (int i = 0; is_done && i < workload.open_tournaments_num; i++) {
+        is_done = openTournament(chess, &workload, i);
+    }
+    for (int i = 0; is_done && i < players_num * OPERATIONS_PER_PLAYER; i++) {
+        is_done = runOperation(chess, &workload);
+    }
+    is_done = is_done && runSaves(chess, &workload);
+    for (int operation = 0; operation < OPERATIONS_NUM; operation++) {
+        if (is_done) {
+            printSamples(&workload, seed, operation, &workload.samples[operation]);
+        }
+        free(workload.samples[operation].latencies);
+    }
+    chessDestroy(chess);
+    free(workload.open_tournaments);
+    return is_done;
+}
+
+int main(int argc, char** argv) {
+    unsigned long seed = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_SEED;
+    double remove_ratio = argc > 2 ? atof(argv[2]) : DEFAULT_REMOVE_RATIO;
+    double end_ratio = argc > 3 ? atof(argv[3]) : DEFAULT_END_RATIO;
+    if (remove_ratio < 0 || end_ratio < 0 || remove_ratio + end_ratio > 1) {
+        fprintf(stderr, "usage: %s [seed [remove_ratio [end_ratio]]], with ratios that add up to at most 1\n",
+                argv[0]);
+        return 1;
+    }
+    bool is_done = true;
+    for (int i = 0; is_done && i < (int)(sizeof(scales) / sizeof(scales[0])); i++) {
+        is_done = runScale(seed, remove_ratio, end_ratio, scales[i]);
+    }
+    remove(LEVELS_PATH);
+    remove(STATISTICS_PATH);
+    return is_done ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+#include "checksum.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CHECKSUM_OFFSET UINT64_C(0xcbf29ce484222325)
+#define CHECKSUM_PRIME UINT64_C(0x100000001b3)
+#define WORD_SIZE 8
+
+void checksumStart(Checksum* checksum) {
+    checksum->hash = CHECKSUM_OFFSET;
+    checksum->pending = 0;
+    checksum->pending_bytes = 0;
+}
+
+// the bytes are combined in little endian order, which compiles to a single load on most machines
+static uint64_t loadWord(const unsigned char* bytes) {
+    uint64_t word = 0;
+    for (int i = 0; i < WORD_SIZE; i++) {
+        word |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return word;
+}
+
+static void addWord(Checksum* checksum, uint64_t word) {
+    checksum->hash = (checksum->hash ^ word) * CHECKSUM_PRIME;
+}
+
+void checksumAdd(Checksum* checksum, const void* data, size_t size) {
+    const unsigned char* bytes = data;
+    size_t i = 0;
+    while (i < size && checksum->pending_bytes > 0) {
+        checksum->pending |= (uint64_t)bytes[i++] << (8 * checksum->pending_bytes);
+        if (++checksum->pending_bytes == WORD_SIZE) {
+            addWord(checksum, checksum->pending);
+            checksum->pending = 0;
+            checksum->pending_bytes = 0;
+        }
+    }
+    for (; i + WORD_SIZE <= size; i += WORD_SIZE) {
+        addWord(checksum, loadWord(bytes + i));
+    }
+    for (; i < size; i++) {
+        checksum->pending |= (uint64_t)bytes[i] << (8 * checksum->pending_bytes);
+        checksum->pending_bytes++;
+    }
+}
+
+uint64_t checksumEnd(Checksum* checksum) {
+    if (checksum->pending_bytes > 0) {
+        addWord(checksum, checksum->pending);
+    }
+    // the number of bytes in the last word tells apart data that only differs by trailing zeros
+    addWord(checksum, (uint64_t)checksum->pending_bytes);
+    return checksum->hash;
+}
@@ -0,0 +1,48 @@
+#ifndef _CHECKSUM_H
+#define _CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Type for a checksum that is calculated over data that may arrive in pieces of any size, 8 bytes at a time.
+ * The result only depends on the bytes, not on how they were split. Its fields are private to checksum.c,
+ * and it's declared here only so it can live on the stack.
+ */
+typedef struct {
+    uint64_t hash;
+    uint64_t pending;
+    int pending_bytes;
+} Checksum;
+
+
+/**
+ * checksumStart: starts a checksum of no data.
+ *
+ * @param checksum - the checksum to start.
+ *
+ */
+void checksumStart(Checksum* checksum);
+
+/**
+ * checksumAdd: adds the bytes that follow the data already added to a checksum.
+ *
+ * @param checksum - a started checksum.
+ * @param data - the bytes to add. May be NULL if size is 0.
+ * @param size - the number of bytes.
+ *
+ */
+void checksumAdd(Checksum* checksum, const void* data, size_t size);
+
+/**
+ * checksumEnd: gives the checksum of all the data that was added. The checksum must be started again
+ *              before it's used for other data.
+ *
+ * @param checksum - a started checksum.
+ *
+ * @return the checksum of the data.
+ *
+ */
+uint64_t checksumEnd(Checksum* checksum);
+
+#endif //_CHECKSUM_H
@@ -1,9 +1,24 @@
+#define _POSIX_C_SOURCE 200112L
+
 #include "chessSystem.h"
+#include "chessSystemExtensions.h"
 #include "map.h"
+#include "mapExtensions.h"
+#include "pool.h"
+#include "pairSet.h"
+#include "leaderboard.h"
+#include "rankTable.h"
+#include "parallel.h"
 #include "tournament.h"
 #include "game.h"
 #include "player.h"
 #include "participance.h"
+#include "snapshot.h"
+#include "journal.h"
+#include "importer.h"
+#include "metrics.h"
+#include "locks.h"
+#include "commandQueue.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,13 +26,36 @@
 #include <stdbool.h>
 #include <ctype.h>
 #include <assert.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 
-#define NUM_OF_COMPONENTS 2
 #define UNDEFINED -1
+// the number of players a thread should rank at least, for the thread to be worth starting
+#define ROWS_PER_THREAD 32768
+// files are saved through one buffer of this size, so a save takes a single open and few large writes
+#define SAVE_BUFFER_SIZE (1 << 16)
+// a snapshot is written next to its destination and renamed over it once complete,
+// so an existing snapshot is never left half written
+#define SNAPSHOT_TEMP_SUFFIX ".tmp"
 
 struct chess_system_t {
     Map tournaments; 
     Map players; 
+    Leaderboard leaderboard;
+    ChessSyncPolicy sync_policy;
+    Journal journal; // NULL unless the changes to the system are logged
+    Locks locks; // NULL unless the system is thread safe
+    CommandQueue queue; // NULL unless the queued commands are applied by a thread of their own
+};
+
+struct chess_view_t {
+    LeaderboardView levels;
+    // the statistics of the ended tournaments, in the order of their ids
+    Statistics* statistics;
+    int statistics_num;
+    ChessSyncPolicy sync_policy;
 };
 
 ChessSystem chessCreate() {
@@ -26,20 +64,32 @@ ChessSystem chessCreate() {
         printf("Dynamic Allocation Error");
         return NULL;
     }
-    Map tournaments = mapCreate(tournamentCopy, idCopy, (freeMapDataElements)tournamentDestroy, idFree, idCompare);                                      
+    Map tournaments = mapCreateIntKeyed(tournamentCopy, (freeMapDataElements)tournamentDestroy);
     if (tournaments == NULL) {
         printf("Dynamic Allocation Error");
         free(chess_system_t);
         return NULL;
     }
     chess_system_t->tournaments = tournaments;
-    chess_system_t->players = mapCreate(playerCopy, idCopy, (freeMapDataElements)playerDestroy, idFree, idCompare);                                    ;
+    chess_system_t->players = mapCreateIntKeyed(playerCopy, (freeMapDataElements)playerDestroy);
     if (chess_system_t->players == NULL){
         printf("Dynamic Allocation Error");
         mapDestroy(chess_system_t->tournaments);
         free(chess_system_t);
         return NULL;
     }
+    chess_system_t->leaderboard = leaderboardCreate();
+    if (chess_system_t->leaderboard == NULL){
+        printf("Dynamic Allocation Error");
+        mapDestroy(chess_system_t->players);
+        mapDestroy(chess_system_t->tournaments);
+        free(chess_system_t);
+        return NULL;
+    }
+    chess_system_t->sync_policy = CHESS_SYNC_NONE;
+    chess_system_t->journal = NULL;
+    chess_system_t->locks = NULL;
+    chess_system_t->queue = NULL;
     return chess_system_t;
 }
 
@@ -47,13 +97,19 @@ void chessDestroy(ChessSystem chess_system) {
     if(chess_system == NULL) {
         return;
     }
-    mapDestroy(chess_system->tournaments);
+    // the commands that are still queued are applied first
+    commandQueueDestroy(chess_system->queue);
+    // players go first, their participances are returned to the pools of the tournaments
     mapDestroy(chess_system->players);
+    mapDestroy(chess_system->tournaments);
+    leaderboardDestroy(chess_system->leaderboard);
+    journalClose(chess_system->journal);
+    locksDestroy(chess_system->locks);
     free(chess_system);
 }
 
-ChessResult chessAddTournament (ChessSystem chess, int tournament_id,
-                                int max_games_per_player, const char* tournament_location) {
+static ChessResult addTournament(ChessSystem chess, int tournament_id,
+                                 int max_games_per_player, const char* tournament_location) {
     if (chess == NULL || tournament_location == NULL) {
         return CHESS_NULL_ARGUMENT;
     }
@@ -67,17 +123,53 @@ ChessResult chessAddTournament (ChessSystem chess, int tournament_id,
         return res_of_create;
     }
     assert(res_of_create == CHESS_SUCCESS);
-    MapResult res_of_put = mapPut(chess->tournaments, &tournament_id, tournament);
-
-    tournamentDestroy(tournament);
-
+    MapResult res_of_put = mapPutMove(chess->tournaments, &tournament_id, tournament);
     if (res_of_put != MAP_SUCCESS) {
+        tournamentDestroy(tournament);
         return CHESS_OUT_OF_MEMORY;
     }
+    journalAddTournament(chess->journal, tournament_id, max_games_per_player, tournament_location);
     return CHESS_SUCCESS; 
 }
 
-ChessResult chessRemoveTournament (ChessSystem chess, int tournament_id) {
+static void finishDeferredPlayer(int player_id, void* chess) {
+    ChessSystem chess_system = chess;
+    playerFinishDeferredMove(chess_system->players, player_id, chess_system->leaderboard);
+}
+
+// locks a thread safe system for a call that runs alone. the leaderboard moves deferred by the calls that ran
+// together are finished first, so the call finds every player at his place.
+static void lockExclusive(ChessSystem chess) {
+    if (chess == NULL || chess->locks == NULL) {
+        return;
+    }
+    locksLockExclusive(chess->locks);
+    locksFinishDeferredPlayers(chess->locks, finishDeferredPlayer, chess);
+}
+
+static void lockShared(ChessSystem chess) {
+    if (chess != NULL && chess->locks != NULL) {
+        locksLockShared(chess->locks);
+    }
+}
+
+static void unlock(ChessSystem chess) {
+    if (chess != NULL && chess->locks != NULL) {
+        locksUnlock(chess->locks);
+    }
+}
+
+ChessResult chessAddTournament(ChessSystem chess, int tournament_id, int max_games_per_player,
+                               const char* tournament_location) {
+    METRICS_START(start);
+    lockExclusive(chess);
+    ChessResult result = addTournament(chess, tournament_id, max_games_per_player, tournament_location);
+    unlock(chess);
+    METRICS_RECORD(CHESS_API_ADD_TOURNAMENT, result, start);
+    return result;
+}
+
+static ChessResult removeTournament(ChessSystem chess, int tournament_id) {
     if (chess == NULL){
         return CHESS_NULL_ARGUMENT;
     }
@@ -87,17 +179,26 @@ ChessResult chessRemoveTournament (ChessSystem chess, int tournament_id) {
     if (mapContains(chess->tournaments, &tournament_id) == false){
         return CHESS_TOURNAMENT_NOT_EXIST;
     }
+    playerRemoveTournament(chess->players, mapGet(chess->tournaments, &tournament_id));
     MapResult remove_res = mapRemove(chess->tournaments, &tournament_id);
     if(remove_res != MAP_SUCCESS){
         return CHESS_OUT_OF_MEMORY;
     }
+    journalRemoveTournament(chess->journal, tournament_id);
     return CHESS_SUCCESS;
 }
+
+ChessResult chessRemoveTournament(ChessSystem chess, int tournament_id) {
+    METRICS_START(start);
+    lockExclusive(chess);
+    ChessResult result = removeTournament(chess, tournament_id);
+    unlock(chess);
+    METRICS_RECORD(CHESS_API_REMOVE_TOURNAMENT, result, start);
+    return result;
+}
   
-ChessResult chessEndTournament(ChessSystem chess, int tournament_id) {
-    if(chess == NULL){
-        return CHESS_NULL_ARGUMENT;
-    }
+// checks if a tournament can be ended
+static ChessResult validateEnd(ChessSystem chess, int tournament_id) {
     if (tournamentValidateId (tournament_id) == false){
         return CHESS_INVALID_ID;
     }
@@ -111,79 +212,484 @@ ChessResult chessEndTournament(ChessSystem chess, int tournament_id) {
     if(mapGetSize(tournamentGetGames(tournament)) == 0){
         return CHESS_NO_GAMES;
     }
-    ChessResult res = CHESS_SUCCESS;
-    tournamentEnd(chess->tournaments, tournament_id);
+    return CHESS_SUCCESS;
+}
+
+static ChessResult endTournament(ChessSystem chess, int tournament_id) {
+    if(chess == NULL){
+        return CHESS_NULL_ARGUMENT;
+    }
+    ChessResult res = validateEnd(chess, tournament_id);
     if (res != CHESS_SUCCESS){
         return res;
     }
-    int winner_id = tournamentCalculateWinnerId(chess->tournaments, chess->players, tournament_id);
-    if (winner_id == -1)
-        return CHESS_OUT_OF_MEMORY; 
+    tournamentEnd(chess->tournaments, tournament_id);
+    int winner_id = tournamentCalculateWinnerId(mapGet(chess->tournaments, &tournament_id));
     winnerIdUpdate(chess->tournaments, tournament_id, winner_id);
+    journalEndTournament(chess->journal, tournament_id);
     return res; 
 }
 
-ChessResult chessSaveTournamentStatistics (ChessSystem chess, char* path_file) {
+ChessResult chessEndTournament(ChessSystem chess, int tournament_id) {
+    METRICS_START(start);
+    // ending a tournament only changes the tournament, so it runs together with the games of the others
+    lockShared(chess);
+    if (chess != NULL && chess->locks != NULL) {
+        locksLockTournament(chess->locks, tournament_id);
+    }
+    ChessResult result = endTournament(chess, tournament_id);
+    if (chess != NULL && chess->locks != NULL) {
+        locksUnlockTournament(chess->locks, tournament_id);
+    }
+    unlock(chess);
+    METRICS_RECORD(CHESS_API_END_TOURNAMENT, result, start);
+    return result;
+}
+
+// the tournaments of a batch whose winners are calculated in parallel
+typedef struct {
+    Tournament* tournaments;
+    int* winner_ids;
+} WinnerBatch;
+
+static void calculateBatchWinner(int index, void* context) {
+    WinnerBatch* batch = context;
+    batch->winner_ids[index] = tournamentCalculateWinnerId(batch->tournaments[index]);
+}
+
+static ChessResult endTournaments(ChessSystem chess, const int* tournament_ids, int n, ChessResult* results) {
+    if (chess == NULL || (tournament_ids == NULL && n > 0)) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (n <= 0) {
+        return CHESS_SUCCESS;
+    }
+    Tournament* tournaments = malloc(sizeof(*tournaments) * n);
+    int* batch_ids = malloc(sizeof(*batch_ids) * n);
+    int* winner_ids = malloc(sizeof(*winner_ids) * n);
+    if (tournaments == NULL || batch_ids == NULL || winner_ids == NULL) {
+        free(tournaments);
+        free(batch_ids);
+        free(winner_ids);
+        return CHESS_OUT_OF_MEMORY;
+    }
+
+    // the tournaments are validated and ended in order, so an id that appears twice is already ended
+    // the second time, like with calls of chessEndTournament
+    ChessResult first_failure = CHESS_SUCCESS;
+    int batch_size = 0;
+    int rows = 0;
+    for (int i = 0; i < n; i++) {
+        ChessResult res = validateEnd(chess, tournament_ids[i]);
+        if (res == CHESS_SUCCESS) {
+            tournaments[batch_size] = mapGet(chess->tournaments, (MapKeyElement)&tournament_ids[i]);
+            batch_ids[batch_size] = tournament_ids[i];
+            tournamentEnd(chess->tournaments, tournament_ids[i]);
+            rows += mapGetSize(tournamentGetRoster(tournaments[batch_size]));
+            journalEndTournament(chess->journal, tournament_ids[i]);
+            batch_size++;
+        }
+        else if (first_failure == CHESS_SUCCESS) {
+            first_failure = res;
+        }
+        if (results != NULL) {
+            results[i] = res;
+        }
+    }
+
+    WinnerBatch batch = { tournaments, winner_ids };
+    parallelFor(batch_size, calculateBatchWinner, &batch, rows / ROWS_PER_THREAD + 1);
+    for (int i = 0; i < batch_size; i++) {
+        winnerIdUpdate(chess->tournaments, batch_ids[i], winner_ids[i]);
+    }
+
+    free(tournaments);
+    free(batch_ids);
+    free(winner_ids);
+    return first_failure;
+}
+
+ChessResult chessEndTournaments(ChessSystem chess, const int* tournament_ids, int n, ChessResult* results) {
+    METRICS_START(start);
+    lockExclusive(chess);
+    ChessResult result = endTournaments(chess, tournament_ids, n, results);
+    unlock(chess);
+    METRICS_RECORD(CHESS_API_END_TOURNAMENTS, result, start);
+    return result;
+}
+
+// flushes a saved file, and makes sure it reached the disk if the policy asks for it
+static ChessResult syncFile(FILE* file, ChessSyncPolicy sync_policy) {
+    if (fflush(file) != 0) {
+        return CHESS_SAVE_FAILURE;
+    }
+    if (sync_policy == CHESS_SYNC_ON_SAVE && fsync(fileno(file)) != 0) {
+        return CHESS_SAVE_FAILURE;
+    }
+    return CHESS_SUCCESS;
+}
+
+// opens a file to save to with a large buffer, which is freed by closeSaved
+static FILE* openForSave(const char* path_file, const char* mode, char** buffer) {
+    *buffer = NULL;
+    FILE* file = fopen(path_file, mode);
+    if (file == NULL) {
+        return NULL;
+    }
+    // without its own buffer the stream still works, only with more writes
+    *buffer = malloc(SAVE_BUFFER_SIZE);
+    if (*buffer != NULL && setvbuf(file, *buffer, _IOFBF, SAVE_BUFFER_SIZE) != 0) {
+        free(*buffer);
+        *buffer = NULL;
+    }
+    return file;
+}
+
+// finishes a save that has so far ended with a given result, and gives its final result
+static ChessResult closeSaved(FILE* file, char* buffer, ChessSyncPolicy sync_policy, ChessResult result) {
+    if (result == CHESS_SUCCESS) {
+        result = syncFile(file, sync_policy);
+    }
+    if (fclose(file) != 0) {
+        result = CHESS_SAVE_FAILURE;
+    }
+    free(buffer);
+    return result;
+}
+
+static ChessResult saveTournamentStatistics(ChessSystem chess, char* path_file) {
     if (chess == NULL) {
         return CHESS_NULL_ARGUMENT;
     }
-    Tournament curr_tournament;
-    int counter = 0; 
-    MAP_FOREACH(int*, tournament_iter, chess->tournaments) {
-        curr_tournament = mapGet(chess->tournaments, tournament_iter);
-        if(tournamentCheckIfEnded(curr_tournament) == true) {
-            counter++; 
-            if (printStatistics(chess->players, path_file, curr_tournament) != CHESS_SUCCESS)
+    // the file is opened on the first ended tournament, so it isn't touched when no tournament ended
+    FILE* statistics = NULL;
+    char* buffer = NULL;
+    ChessResult result = CHESS_SUCCESS;
+    MAP_FOREACH_BORROWED(int*, tournament_iter, chess->tournaments) {
+        Tournament curr_tournament = mapGetCurrent(chess->tournaments);
+        if (!tournamentCheckIfEnded(curr_tournament)) {
+            continue;
+        }
+        if (statistics == NULL) {
+            statistics = openForSave(path_file, "w", &buffer);
+            if (statistics == NULL) {
                 return CHESS_SAVE_FAILURE;
             }
-        free(tournament_iter);
+        }
+        result = printStatistics(statistics, curr_tournament);
+        if (result != CHESS_SUCCESS) {
+            break;
+        }
     }
-    if (counter == 0) {
+    if (statistics == NULL) {
         return CHESS_NO_TOURNAMENTS_ENDED;
     }
-    return CHESS_SUCCESS; 
+    return closeSaved(statistics, buffer, chess->sync_policy, result);
 }
 
-ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player,
-                         int second_player, Winner winner, int play_time) {
-    if(chess == NULL)
+ChessResult chessSaveTournamentStatistics(ChessSystem chess, char* path_file) {
+    METRICS_START(start);
+    lockExclusive(chess);
+    ChessResult result = saveTournamentStatistics(chess, path_file);
+    unlock(chess);
+    METRICS_RECORD(CHESS_API_SAVE_TOURNAMENT_STATISTICS, result, start);
+    return result;
+}
+
+static ChessResult saveSnapshot(ChessSystem chess, const char* path_file) {
+    if (chess == NULL || path_file == NULL) {
         return CHESS_NULL_ARGUMENT;
-    
-    ChessResult validity = (gameDataValidate(chess->tournaments, chess->players, tournament_id, 
-                                            first_player, second_player, play_time));
+    }
+    char* temp_path = malloc(strlen(path_file) + strlen(SNAPSHOT_TEMP_SUFFIX) + 1);
+    if (temp_path == NULL) {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    strcpy(temp_path, path_file);
+    strcat(temp_path, SNAPSHOT_TEMP_SUFFIX);
+    char* buffer = NULL;
+    FILE* snapshot = openForSave(temp_path, "wb", &buffer);
+    if (snapshot == NULL) {
+        free(temp_path);
+        return CHESS_SAVE_FAILURE;
+    }
+    ChessResult result = snapshotWrite(snapshot, chess->tournaments, chess->players);
+    result = closeSaved(snapshot, buffer, chess->sync_policy, result);
+    if (result == CHESS_SUCCESS && rename(temp_path, path_file) != 0) {
+        result = CHESS_SAVE_FAILURE;
+    }
+    if (result != CHESS_SUCCESS) {
+        remove(temp_path);
+    }
+    free(temp_path);
+    return result;
+}
+
+ChessResult chessSaveSnapshot(ChessSystem chess, const char* path_file) {
+    lockExclusive(chess);
+    ChessResult result = saveSnapshot(chess, path_file);
+    unlock(chess);
+    return result;
+}
+
+// maps a whole file to memory for reading. returns NULL if it couldn't be mapped.
+static void* mapFile(const char* path_file, size_t* size) {
+    int file = open(path_file, O_RDONLY);
+    if (file < 0) {
+        return NULL;
+    }
+    struct stat file_status;
+    void* data = MAP_FAILED;
+    if (fstat(file, &file_status) == 0 && file_status.st_size > 0) {
+        *size = file_status.st_size;
+        data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    // the mapping stays valid after the file is closed
+    close(file);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+    posix_madvise(data, *size, POSIX_MADV_SEQUENTIAL);
+    return data;
+}
+
+ChessSystem chessLoadSnapshot(const char* path_file, ChessResult* chess_result) {
+    ChessResult result = CHESS_SUCCESS;
+    ChessSystem chess = NULL;
+    size_t size = 0;
+    void* data = NULL;
+    if (path_file == NULL) {
+        result = CHESS_NULL_ARGUMENT;
+    }
+    else if ((data = mapFile(path_file, &size)) == NULL) {
+        result = CHESS_SAVE_FAILURE;
+    }
+    else if ((chess = chessCreate()) == NULL) {
+        result = CHESS_OUT_OF_MEMORY;
+    }
+    else {
+        result = snapshotRead(data, size, chess->tournaments, chess->players, chess->leaderboard);
+        if (result != CHESS_SUCCESS) {
+            chessDestroy(chess);
+            chess = NULL;
+        }
+    }
+    if (data != NULL) {
+        munmap(data, size);
+    }
+    if (chess_result != NULL) {
+        *chess_result = result;
+    }
+    return chess;
+}
+
+// adds a game to a tournament that was already looked up by its id, or is NULL if there is no such tournament.
+// with defer_move the players are left for the caller to move in the leaderboard, as updatePlayersData describes.
+static ChessResult addGame(ChessSystem chess, Tournament tournament, const GameRecord* record, bool defer_move) {
+    Player game_players[2];
+    Participance participances[2];
+    ChessResult validity = gameDataValidate(tournament, chess->players, record->tournament_id, record->first_player,
+                                            record->second_player, record->play_time, game_players, participances);
+    // a game that exceeds the limit may still have added its players to the tournament,
+    // so it's logged for the players to be added again when the journal is replayed
+    if(validity == CHESS_EXCEEDED_GAMES)
+        journalAddGame(chess->journal, record->tournament_id, record->first_player, record->second_player,
+                       record->winner, record->play_time);
     if(validity != CHESS_SUCCESS)
         return validity;
-    int game_id = gameMakeId(chess->tournaments, tournament_id);
-    Tournament tournament = mapGet(chess->tournaments, &tournament_id);
-    Game game = gameCreate(game_id, first_player, second_player, winner, play_time);
+    int game_id = gameMakeId(tournament);
+    Game game = gameCreate(tournamentGetGamesPool(tournament), game_id, record->first_player, record->second_player,
+                           record->winner, record->play_time);
     if (game == NULL)
         return CHESS_OUT_OF_MEMORY;
     
     Map games = tournamentGetGames(tournament);
-    MapResult res_of_put = mapPut(games, &game_id, game);
-    gameDestroy(game);
+    PairSet played_pairs = tournamentGetPlayedPairs(tournament);
+    if (!pairSetAdd(played_pairs, record->first_player, record->second_player)) {
+        gameDestroy(game);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    MapResult res_of_put = mapPutMove(games, &game_id, game);
     if (res_of_put != MAP_SUCCESS){
+        pairSetRemove(played_pairs, record->first_player, record->second_player);
+        gameDestroy(game);
         return CHESS_OUT_OF_MEMORY;
     }
 
-    ChessResult res_of_update = updatePlayersData(chess->players, first_player, second_player, winner, play_time, tournament_id);
-    if(res_of_update != CHESS_SUCCESS)
+    ChessResult res_of_update = updatePlayersData(chess->leaderboard, game_players[0], participances[0],
+                                                  game_players[1], participances[1],
+                                                  record->winner, record->play_time, game_id, defer_move);
+    if(res_of_update != CHESS_SUCCESS){
+        mapRemove(games, &game_id);
+        pairSetRemove(played_pairs, record->first_player, record->second_player);
         return res_of_update;
+    }
+    tournamentRecordGame(tournament, record->first_player, record->second_player, record->play_time);
+    journalAddGame(chess->journal, record->tournament_id, record->first_player, record->second_player,
+                   record->winner, record->play_time);
     return CHESS_SUCCESS;
 }
 
-ChessResult chessRemovePlayer(ChessSystem chess, int player_id) {
+// remembers that a game deferred the move of a player in the leaderboard, for the next call that runs alone
+// to finish it. if the player can't be remembered, the move is finished at once.
+static void deferMove(ChessSystem chess, Player player, bool was_deferred, bool is_leaderboard_locked) {
+    if (was_deferred || !playerIsMoveDeferred(player) || locksDeferPlayer(chess->locks, playerGetId(player)))
+        return;
+    if (!is_leaderboard_locked)
+        locksLockLeaderboard(chess->locks);
+    playerFinishDeferredMove(chess->players, playerGetId(player), chess->leaderboard);
+    if (!is_leaderboard_locked)
+        locksUnlockLeaderboard(chess->locks);
+}
+
+// adds a game to a thread safe system. the game locks the shard of its tournament and the stripes of its players,
+// so games of other tournaments and other players are added at the same time. moving the players in the
+// leaderboard is deferred, and only a player's first game, which inserts him there, locks the leaderboard.
+// a game of a player who isn't in the system yet changes the map of the players, so it runs alone.
+static ChessResult addGameThreadSafe(ChessSystem chess, const GameRecord* record) {
+    Locks locks = chess->locks;
+    locksLockShared(locks);
+    Player first = mapGet(chess->players, (MapKeyElement)&record->first_player);
+    Player second = mapGet(chess->players, (MapKeyElement)&record->second_player);
+    if (first == NULL || second == NULL) {
+        locksUnlock(locks);
+        lockExclusive(chess);
+        ChessResult result = addGame(chess, mapGet(chess->tournaments, (MapKeyElement)&record->tournament_id),
+                                     record, false);
+        locksUnlock(locks);
+        return result;
+    }
+    locksLockTournament(locks, record->tournament_id);
+    locksLockPlayers(locks, record->first_player, record->second_player);
+    bool is_leaderboard_locked = playerGetNumOfGames(first) == 0 || playerGetNumOfGames(second) == 0;
+    if (is_leaderboard_locked)
+        locksLockLeaderboard(locks);
+    bool was_first_deferred = playerIsMoveDeferred(first), was_second_deferred = playerIsMoveDeferred(second);
+    ChessResult result = addGame(chess, mapGet(chess->tournaments, (MapKeyElement)&record->tournament_id),
+                                 record, true);
+    if (result == CHESS_SUCCESS) {
+        deferMove(chess, first, was_first_deferred, is_leaderboard_locked);
+        deferMove(chess, second, was_second_deferred, is_leaderboard_locked);
+    }
+    if (is_leaderboard_locked)
+        locksUnlockLeaderboard(locks);
+    locksUnlockPlayers(locks, record->first_player, record->second_player);
+    locksUnlockTournament(locks, record->tournament_id);
+    locksUnlock(locks);
+    return result;
+}
+
+ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player,
+                         int second_player, Winner winner, int play_time) {
+    METRICS_START(start);
+    ChessResult result = CHESS_NULL_ARGUMENT;
+    if(chess != NULL) {
+        GameRecord record = { tournament_id, first_player, second_player, winner, play_time };
+        if(chess->locks == NULL)
+            result = addGame(chess, mapGet(chess->tournaments, &tournament_id), &record, false);
+        else
+            result = addGameThreadSafe(chess, &record);
+    }
+    METRICS_RECORD(CHESS_API_ADD_GAME, result, start);
+    return result;
+}
+
+// makes room for the games of a run of records of the same tournament, so they are added without growing
+// its maps one step at a time. only runs that at least double the tournament reserve, since smaller ones are
+// cheap to grow into and reserving exactly for each of them would copy the maps over and over.
+// failing here isn't an error, since every game still grows what it needs.
+static void reserveGames(Tournament tournament, int games_num) {
+    Map games = tournamentGetGames(tournament);
+    if (games_num < mapGetSize(games)) {
+        return;
+    }
+    int size = mapGetSize(games) + games_num;
+    mapReserve(games, size);
+    // there are never more played pairs than games
+    pairSetReserve(tournamentGetPlayedPairs(tournament), size);
+}
+
+static ChessResult addGames(ChessSystem chess, const GameRecord* records, int n, ChessResult* results) {
+    if (chess == NULL || (records == NULL && n > 0)) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    // the records are added in order, exactly like calls of chessAddGame, but a run of records of the same
+    // tournament shares one lookup of it, since the tournament can't be removed in the middle of the batch.
+    // nothing reads the levels until the batch is over, so every player is moved in the leaderboard once, at the end
+    ChessResult first_failure = CHESS_SUCCESS;
+    Tournament tournament = NULL;
+    int run_end = 0;
+    for (int i = 0; i < n; i++) {
+        if (i == run_end) {
+            tournament = mapGet(chess->tournaments, (MapKeyElement)&records[i].tournament_id);
+            while (run_end < n && records[run_end].tournament_id == records[i].tournament_id) {
+                run_end++;
+            }
+            if (tournament != NULL && !tournamentCheckIfEnded(tournament)) {
+                reserveGames(tournament, run_end - i);
+            }
+        }
+        ChessResult res = addGame(chess, tournament, &records[i], true);
+        if (res != CHESS_SUCCESS && first_failure == CHESS_SUCCESS) {
+            first_failure = res;
+        }
+        if (results != NULL) {
+            results[i] = res;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        playerFinishDeferredMove(chess->players, records[i].first_player, chess->leaderboard);
+        playerFinishDeferredMove(chess->players, records[i].second_player, chess->leaderboard);
+    }
+    return first_failure;
+}
+
+ChessResult chessAddGames(ChessSystem chess, const GameRecord* records, int n, ChessResult* results) {
+    METRICS_START(start);
+    lockExclusive(chess);
+    ChessResult result = addGames(chess, records, n, results);
+    unlock(chess);
+    METRICS_RECORD(CHESS_API_ADD_GAMES, result, start);
+    return result;
+}
+
+ChessResult chessImportResults(ChessSystem chess, const char* path_file, ChessImportReport* report) {
+    if (chess == NULL || path_file == NULL || report == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    int file = open(path_file, O_RDONLY);
+    if (file < 0) {
+        memset(report, 0, sizeof(*report));
+        return CHESS_SAVE_FAILURE;
+    }
+    posix_fadvise(file, 0, 0, POSIX_FADV_SEQUENTIAL);
+    ChessResult result = importerRead(chess, file, report);
+    close(file);
+    return result;
+}
+
+static ChessResult removePlayer(ChessSystem chess, int player_id) {
     ChessResult validity = playerDataValidate(chess->players, player_id);
     if(validity != CHESS_SUCCESS)
         return validity;
-    setOpponentAsWinner(chess->tournaments, player_id);
+    setOpponentAsWinner(chess->tournaments, chess->players, player_id);
+    playerRemoveFromLeaderboard(chess->players, player_id, chess->leaderboard);
     if (mapRemove(chess->players, &player_id) != MAP_SUCCESS) {
         return CHESS_OUT_OF_MEMORY;
     }
+    journalRemovePlayer(chess->journal, player_id);
     return CHESS_SUCCESS;
 }
 
-double chessCalculateAveragePlayTime (ChessSystem chess, int player_id, ChessResult* chess_result) {
+ChessResult chessRemovePlayer(ChessSystem chess, int player_id) {
+    METRICS_START(start);
+    lockExclusive(chess);
+    ChessResult result = removePlayer(chess, player_id);
+    unlock(chess);
+    METRICS_RECORD(CHESS_API_REMOVE_PLAYER, result, start);
+    return result;
+}
+
+static double calculateAveragePlayTime(ChessSystem chess, int player_id, ChessResult* chess_result) {
     *chess_result = CHESS_SUCCESS;
     if(chess == NULL){
         *chess_result = CHESS_NULL_ARGUMENT;
@@ -197,17 +703,426 @@ double chessCalculateAveragePlayTime (ChessSystem chess, int player_id, ChessRes
     return average_time;
 }
 
-ChessResult chessSavePlayersLevels (ChessSystem chess, FILE* file) {
+// the results of the player are read without the lock of his stripe, so the reader doesn't wait for the games
+// of the player and they don't wait for it. the shared lock only keeps the player from being removed
+double chessCalculateAveragePlayTime(ChessSystem chess, int player_id, ChessResult* chess_result) {
+    METRICS_START(start);
+    lockShared(chess);
+    double average_time = calculateAveragePlayTime(chess, player_id, chess_result);
+    unlock(chess);
+    METRICS_RECORD(CHESS_API_CALCULATE_AVERAGE_PLAY_TIME, *chess_result, start);
+    return average_time;
+}
+
+static ChessResult savePlayersLevels(ChessSystem chess, FILE* file) {
     if(chess == NULL) {
         return CHESS_NULL_ARGUMENT;
     }
-    int players_size = mapGetSize(chess->players);
-    double **players_array = playersRankArrayCreate(players_size, NUM_OF_COMPONENTS);
-    playerAssignLevel(players_array, chess->players);
-    if(!printToFile(chess->players, players_array, file)) {
-        destroyArray(chess->players, players_array);
+    ChessResult result = printToFile(chess->leaderboard, file);
+    // the file belongs to the caller, so it's only flushed when it has to reach the disk
+    if (result != CHESS_SUCCESS || chess->sync_policy == CHESS_SYNC_NONE) {
+        return result;
+    }
+    return syncFile(file, chess->sync_policy);
+}
+
+ChessResult chessSavePlayersLevels(ChessSystem chess, FILE* file) {
+    METRICS_START(start);
+    lockExclusive(chess);
+    ChessResult result = savePlayersLevels(chess, file);
+    unlock(chess);
+    METRICS_RECORD(CHESS_API_SAVE_PLAYERS_LEVELS, result, start);
+    return result;
+}
+
+static ChessView takeView(ChessSystem chess, ChessResult* chess_result) {
+    ChessView view = malloc(sizeof(*view));
+    if (view == NULL) {
+        *chess_result = CHESS_OUT_OF_MEMORY;
+        return NULL;
+    }
+    view->sync_policy = chess->sync_policy;
+    view->statistics_num = 0;
+    view->statistics = malloc(sizeof(*view->statistics) * (mapGetSize(chess->tournaments) + 1));
+    view->levels = leaderboardViewCreate(chess->leaderboard);
+    if (view->statistics == NULL || view->levels == NULL) {
+        chessViewDestroy(view);
+        *chess_result = CHESS_OUT_OF_MEMORY;
+        return NULL;
+    }
+    MAP_FOREACH_BORROWED(int*, tournament_iter, chess->tournaments) {
+        Tournament tournament = mapGetCurrent(chess->tournaments);
+        if (!tournamentCheckIfEnded(tournament)) {
+            continue;
+        }
+        Statistics statistics = tournamentShareStatistics(tournament);
+        if (statistics == NULL) {
+            chessViewDestroy(view);
+            *chess_result = CHESS_OUT_OF_MEMORY;
+            return NULL;
+        }
+        view->statistics[view->statistics_num++] = statistics;
+    }
+    *chess_result = CHESS_SUCCESS;
+    return view;
+}
+
+ChessView chessViewCreate(ChessSystem chess, ChessResult* chess_result) {
+    if (chess == NULL) {
+        *chess_result = CHESS_NULL_ARGUMENT;
+        return NULL;
+    }
+    lockExclusive(chess);
+    ChessView view = takeView(chess, chess_result);
+    unlock(chess);
+    return view;
+}
+
+void chessViewDestroy(ChessView view) {
+    if (view == NULL) {
+        return;
+    }
+    leaderboardViewDestroy(view->levels);
+    for (int i = 0; i < view->statistics_num; i++) {
+        statisticsRelease(view->statistics[i]);
+    }
+    free(view->statistics);
+    free(view);
+}
+
+ChessResult chessViewSavePlayersLevels(ChessView view, FILE* file) {
+    if (view == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    ChessResult result = printViewToFile(view->levels, file);
+    if (result != CHESS_SUCCESS || view->sync_policy == CHESS_SYNC_NONE) {
+        return result;
+    }
+    return syncFile(file, view->sync_policy);
+}
+
+ChessResult chessViewSaveTournamentStatistics(ChessView view, char* path_file) {
+    if (view == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (view->statistics_num == 0) {
+        return CHESS_NO_TOURNAMENTS_ENDED;
+    }
+    char* buffer = NULL;
+    FILE* statistics = openForSave(path_file, "w", &buffer);
+    if (statistics == NULL) {
         return CHESS_SAVE_FAILURE;
     }
-    destroyArray(chess->players, players_array);
+    ChessResult result = CHESS_SUCCESS;
+    for (int i = 0; i < view->statistics_num && result == CHESS_SUCCESS; i++) {
+        result = statisticsPrint(statistics, view->statistics[i]);
+    }
+    return closeSaved(statistics, buffer, view->sync_policy, result);
+}
+
+ChessResult chessSetSyncPolicy(ChessSystem chess, ChessSyncPolicy sync_policy) {
+    if (chess == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    lockExclusive(chess);
+    chess->sync_policy = sync_policy;
+    journalSetSyncPolicy(chess->journal, sync_policy);
+    unlock(chess);
     return CHESS_SUCCESS;
 }
+
+ChessResult chessJournalOpen(ChessSystem chess, const char* path_file, int group_size) {
+    if (chess == NULL || path_file == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    lockExclusive(chess);
+    ChessResult result = journalClose(chess->journal);
+    chess->journal = NULL;
+    if (result == CHESS_SUCCESS) {
+        chess->journal = journalOpen(path_file, group_size, chess->sync_policy, &result);
+    }
+    unlock(chess);
+    return result;
+}
+
+ChessResult chessJournalCommit(ChessSystem chess) {
+    if (chess == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    // the journal keeps its records under its own lock, so committing them runs together with other calls
+    lockShared(chess);
+    ChessResult result = chess->journal == NULL ? CHESS_SUCCESS : journalCommit(chess->journal);
+    unlock(chess);
+    return result;
+}
+
+ChessResult chessJournalClose(ChessSystem chess) {
+    if (chess == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    lockExclusive(chess);
+    ChessResult result = journalClose(chess->journal);
+    chess->journal = NULL;
+    unlock(chess);
+    return result;
+}
+
+// cuts the records that weren't completely written off the end of a journal file
+static ChessResult truncateFile(const char* path_file, size_t size) {
+    int file = open(path_file, O_WRONLY);
+    if (file < 0) {
+        return CHESS_SAVE_FAILURE;
+    }
+    ChessResult result = ftruncate(file, size) == 0 ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+    if (close(file) != 0) {
+        result = CHESS_SAVE_FAILURE;
+    }
+    return result;
+}
+
+int chessRecover(ChessSystem chess, const char* path_file, ChessResult* chess_result) {
+    ChessResult result = CHESS_SUCCESS;
+    int records_num = 0;
+    size_t size = 0;
+    void* data = NULL;
+    struct stat file_status;
+    if (chess == NULL || path_file == NULL) {
+        result = CHESS_NULL_ARGUMENT;
+    }
+    // a journal that was never created has nothing to replay
+    else if (stat(path_file, &file_status) != 0 || file_status.st_size == 0) {
+        result = CHESS_SUCCESS;
+    }
+    else if ((data = mapFile(path_file, &size)) == NULL) {
+        result = CHESS_SAVE_FAILURE;
+    }
+    else {
+        // the replayed calls were logged when they were first made
+        Journal journal = chess->journal;
+        chess->journal = NULL;
+        size_t valid_size = 0;
+        records_num = journalReplay(chess, data, size, &valid_size, &result);
+        chess->journal = journal;
+        munmap(data, size);
+        if (result == CHESS_SUCCESS && valid_size < size) {
+            result = truncateFile(path_file, valid_size);
+        }
+    }
+    if (chess_result != NULL) {
+        *chess_result = result;
+    }
+    return records_num;
+}
+
+// the state of a walk that collects the first players of the leaderboard
+typedef struct {
+    int* player_ids;
+    double* levels;
+    int max_count;
+    int count;
+} TopPlayers;
+
+static bool collectTopPlayer(int player_id, double level, void* context) {
+    TopPlayers* top_players = context;
+    if (top_players->count == top_players->max_count) {
+        return false;
+    }
+    top_players->player_ids[top_players->count] = player_id;
+    if (top_players->levels != NULL) {
+        top_players->levels[top_players->count] = level;
+    }
+    top_players->count++;
+    return true;
+}
+
+static int getTopPlayers(ChessSystem chess, int k, int* player_ids, double* levels, ChessResult* chess_result) {
+    *chess_result = CHESS_SUCCESS;
+    if (chess == NULL || player_ids == NULL) {
+        *chess_result = CHESS_NULL_ARGUMENT;
+        return 0;
+    }
+    TopPlayers top_players = { player_ids, levels, k < 0 ? 0 : k, 0 };
+    leaderboardWalk(chess->leaderboard, collectTopPlayer, &top_players);
+    return top_players.count;
+}
+
+int chessGetTopPlayers(ChessSystem chess, int k, int* player_ids, double* levels, ChessResult* chess_result) {
+    METRICS_START(start);
+    lockExclusive(chess);
+    int count = getTopPlayers(chess, k, player_ids, levels, chess_result);
+    unlock(chess);
+    METRICS_RECORD(CHESS_API_GET_TOP_PLAYERS, *chess_result, start);
+    return count;
+}
+
+static int getPlayerRank(ChessSystem chess, int player_id, ChessResult* chess_result) {
+    if (chess == NULL) {
+        *chess_result = CHESS_NULL_ARGUMENT;
+        return UNDEFINED;
+    }
+    *chess_result = playerDataValidate(chess->players, player_id);
+    if (*chess_result != CHESS_SUCCESS) {
+        return UNDEFINED;
+    }
+    int rank = playerGetRank(chess->players, player_id, chess->leaderboard);
+    return rank == UNDEFINED ? UNDEFINED : rank + 1;
+}
+
+int chessGetPlayerRank(ChessSystem chess, int player_id, ChessResult* chess_result) {
+    METRICS_START(start);
+    lockExclusive(chess);
+    int rank = getPlayerRank(chess, player_id, chess_result);
+    unlock(chess);
+    METRICS_RECORD(CHESS_API_GET_PLAYER_RANK, *chess_result, start);
+    return rank;
+}
+
+static double getPlayerLevel(ChessSystem chess, int player_id, ChessResult* chess_result) {
+    if (chess == NULL) {
+        *chess_result = CHESS_NULL_ARGUMENT;
+        return UNDEFINED;
+    }
+    *chess_result = playerDataValidate(chess->players, player_id);
+    if (*chess_result != CHESS_SUCCESS) {
+        return UNDEFINED;
+    }
+    return playerReadLevel(chess->players, player_id);
+}
+
+// read like chessCalculateAveragePlayTime, without the lock of the stripe of the player
+double chessGetPlayerLevel(ChessSystem chess, int player_id, ChessResult* chess_result) {
+    METRICS_START(start);
+    lockShared(chess);
+    double level = getPlayerLevel(chess, player_id, chess_result);
+    unlock(chess);
+    METRICS_RECORD(CHESS_API_GET_PLAYER_LEVEL, *chess_result, start);
+    return level;
+}
+
+ChessResult chessGetMetrics(ChessMetrics* metrics) {
+    if (metrics == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    metricsGet(metrics);
+    return CHESS_SUCCESS;
+}
+
+void chessResetMetrics(void) {
+    metricsReset();
+}
+
+ChessResult chessPrintMetrics(const ChessMetrics* metrics, FILE* file) {
+    if (metrics == NULL || file == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    return metricsPrint(metrics, file);
+}
+
+ChessResult chessSetThreadSafe(ChessSystem chess, bool is_thread_safe) {
+    if (chess == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (is_thread_safe && chess->locks == NULL) {
+        chess->locks = locksCreate();
+        if (chess->locks == NULL) {
+            return CHESS_OUT_OF_MEMORY;
+        }
+    }
+    else if (!is_thread_safe && chess->locks != NULL) {
+        locksFinishDeferredPlayers(chess->locks, finishDeferredPlayer, chess);
+        locksDestroy(chess->locks);
+        chess->locks = NULL;
+    }
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessStartQueue(ChessSystem chess, int capacity) {
+    if (chess == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (chess->queue == NULL) {
+        chess->queue = commandQueueCreate(chess, capacity);
+        if (chess->queue == NULL) {
+            return CHESS_OUT_OF_MEMORY;
+        }
+    }
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessStopQueue(ChessSystem chess) {
+    if (chess == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    commandQueueDestroy(chess->queue);
+    chess->queue = NULL;
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessFlushQueue(ChessSystem chess) {
+    if (chess == NULL) {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (chess->queue != NULL) {
+        commandQueueFlush(chess->queue);
+    }
+    return CHESS_SUCCESS;
+}
+
+// pushes a command to the queue of the system, or applies it at once if the system has no queue
+static ChessResult queueCommand(ChessSystem chess, Command* command) {
+    if (chess == NULL) {
+        free(command->location);
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (chess->queue == NULL) {
+        commandApply(chess, command);
+    }
+    else {
+        commandQueuePush(chess->queue, command);
+    }
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessQueueAddTournament(ChessSystem chess, int tournament_id, int max_games_per_player,
+                                    const char* tournament_location, ChessCallback done, void* context) {
+    Command command = { .type = COMMAND_ADD_TOURNAMENT, .max_games_per_player = max_games_per_player,
+                        .location = NULL, .done = done, .context = context };
+    command.game.tournament_id = tournament_id;
+    if (chess != NULL && tournament_location != NULL) {
+        command.location = malloc(strlen(tournament_location) + 1);
+        if (command.location == NULL) {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        strcpy(command.location, tournament_location);
+    }
+    return queueCommand(chess, &command);
+}
+
+static ChessResult queueTournamentCommand(ChessSystem chess, CommandType type, int tournament_id,
+                                          ChessCallback done, void* context) {
+    Command command = { .type = type, .location = NULL, .done = done, .context = context };
+    command.game.tournament_id = tournament_id;
+    return queueCommand(chess, &command);
+}
+
+ChessResult chessQueueRemoveTournament(ChessSystem chess, int tournament_id, ChessCallback done, void* context) {
+    return queueTournamentCommand(chess, COMMAND_REMOVE_TOURNAMENT, tournament_id, done, context);
+}
+
+ChessResult chessQueueEndTournament(ChessSystem chess, int tournament_id, ChessCallback done, void* context) {
+    return queueTournamentCommand(chess, COMMAND_END_TOURNAMENT, tournament_id, done, context);
+}
+
+ChessResult chessQueueAddGame(ChessSystem chess, int tournament_id, int first_player, int second_player,
+                              Winner winner, int play_time, ChessCallback done, void* context) {
+    Command command = { .type = COMMAND_ADD_GAME,
+                        .game = { tournament_id, first_player, second_player, winner, play_time },
+                        .location = NULL, .done = done, .context = context };
+    return queueCommand(chess, &command);
+}
+
+ChessResult chessQueueRemovePlayer(ChessSystem chess, int player_id, ChessCallback done, void* context) {
+    Command command = { .type = COMMAND_REMOVE_PLAYER, .player_id = player_id, .location = NULL, .done = done,
+                        .context = context };
+    return queueCommand(chess, &command);
+}
@@ -0,0 +1,531 @@
+#ifndef _CHESSSYSTEM_EXTENSIONS_H
+#define _CHESSSYSTEM_EXTENSIONS_H
+
+#include "chessSystem.h"
+
+#include <stdbool.h>
+
+/**
+ * Additions to the chess system interface declared in chessSystem.h, implemented in chessSystem.c.
+ */
+
+/** How much the save functions make sure the files they wrote reached the disk */
+typedef enum {
+    CHESS_SYNC_NONE,
+    CHESS_SYNC_ON_SAVE
+} ChessSyncPolicy;
+
+/** A game to add to a tournament, with the arguments of chessAddGame */
+typedef struct {
+    int tournament_id;
+    int first_player;
+    int second_player;
+    Winner winner;
+    int play_time;
+} GameRecord;
+
+/** Type for a frozen view of the reports of a chess system, taken by chessViewCreate */
+typedef struct chess_view_t* ChessView;
+
+/** Type of a function that is called with the result of a queued command, and the context it was queued with */
+typedef void (*ChessCallback)(ChessResult result, void* context);
+
+/** The counts of the records of a file imported by chessImportResults */
+typedef struct {
+    int accepted;
+    int rejected;
+    // the rejected records that couldn't be parsed
+    int malformed;
+    // the other rejected records, by the result they were rejected with. CHESS_SUCCESS is the last result.
+    int rejected_by_result[CHESS_SUCCESS];
+} ChessImportReport;
+
+/** The functions of the chess system whose calls are counted by chessGetMetrics */
+typedef enum {
+    CHESS_API_ADD_TOURNAMENT,
+    CHESS_API_REMOVE_TOURNAMENT,
+    CHESS_API_END_TOURNAMENT,
+    CHESS_API_END_TOURNAMENTS,
+    CHESS_API_ADD_GAME,
+    CHESS_API_ADD_GAMES,
+    CHESS_API_REMOVE_PLAYER,
+    CHESS_API_CALCULATE_AVERAGE_PLAY_TIME,
+    CHESS_API_SAVE_PLAYERS_LEVELS,
+    CHESS_API_SAVE_TOURNAMENT_STATISTICS,
+    CHESS_API_GET_TOP_PLAYERS,
+    CHESS_API_GET_PLAYER_RANK,
+    CHESS_API_GET_PLAYER_LEVEL,
+    CHESS_API_NUM
+} ChessApi;
+
+/** The number of buckets of a latency histogram. Bucket i counts the calls that took from 2^i nanoseconds to
+ *  less than 2^(i+1), except that bucket 0 starts at 0 and the last bucket has no end. */
+#define CHESS_LATENCY_BUCKETS 32
+
+/** The counts of the calls of one function of the chess system */
+typedef struct {
+    unsigned long long calls;
+    // the calls by the result they returned. CHESS_SUCCESS is the last result.
+    unsigned long long results[CHESS_SUCCESS + 1];
+    // the time spent in the calls, only measured when the system is built with CHESS_METRICS_TIMERS
+    unsigned long long total_ns;
+    unsigned long long latency_buckets[CHESS_LATENCY_BUCKETS];
+} ChessApiMetrics;
+
+/** The counts of the work done by all the chess systems of the process, given by chessGetMetrics */
+typedef struct {
+    // whether the system was built with CHESS_METRICS. Nothing is counted without it, and every count is 0.
+    bool is_counted;
+    // whether the system was built with CHESS_METRICS_TIMERS as well, so the calls are also timed
+    bool is_timed;
+    // the work of the maps of the system, as mapGetMetrics describes it
+    unsigned long long map_comparisons;
+    unsigned long long map_copies;
+    unsigned long long map_allocations;
+    unsigned long long map_expansions;
+    ChessApiMetrics apis[CHESS_API_NUM];
+} ChessMetrics;
+
+
+/**
+ * chessGetTopPlayers: gives the players with the highest levels, in the order chessSavePlayersLevels saves them.
+ *                     Only players that played a game have a level. Takes O(log n + k) time.
+ *
+ * @param chess - the chess system. Must be non-NULL.
+ * @param k - the maximum number of players to give.
+ * @param player_ids - an array of at least k ids, to which the ids of the players are written. Must be non-NULL.
+ * @param levels - an array of at least k levels, to which the levels of the players are written. May be NULL.
+ * @param chess_result - pointer to write the result of the operation to.
+ *
+ * @return
+ * the number of players written, which is less than k if fewer players have a level.
+ * chess_result is set to:
+ *     CHESS_NULL_ARGUMENT - if chess or player_ids are NULL.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+int chessGetTopPlayers(ChessSystem chess, int k, int* player_ids, double* levels, ChessResult* chess_result);
+
+/**
+ * chessGetPlayerRank: gives the place of a player in the order chessSavePlayersLevels saves the players in.
+ *                     Takes O(log n) time.
+ *
+ * @param chess - the chess system. Must be non-NULL.
+ * @param player_id - the id of the player.
+ * @param chess_result - pointer to write the result of the operation to.
+ *
+ * @return
+ * -1 if the operation failed or the player didn't play any game yet, or the place of the player,
+ * starting from 1, otherwise.
+ * chess_result is set to:
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_INVALID_ID - if the player id is invalid.
+ *     CHESS_PLAYER_NOT_EXIST - if the player doesn't exist in the system.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+int chessGetPlayerRank(ChessSystem chess, int player_id, ChessResult* chess_result);
+
+/**
+ * chessGetPlayerLevel: gives the level of a player from all the games he played so far, as chessSavePlayersLevels
+ *                      would save it. Takes O(1) time, and in a thread safe system it reads the results of the
+ *                      player without waiting for the games that change them, or holding them up.
+ *
+ * @param chess - the chess system. Must be non-NULL.
+ * @param player_id - the id of the player.
+ * @param chess_result - pointer to write the result of the operation to.
+ *
+ * @return
+ * -1 if the operation failed, 0 if the player didn't play any game yet, or the level of the player otherwise.
+ * A level may be -1 too, so the result tells the cases apart.
+ * chess_result is set to:
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_INVALID_ID - if the player id is invalid.
+ *     CHESS_PLAYER_NOT_EXIST - if the player doesn't exist in the system.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+double chessGetPlayerLevel(ChessSystem chess, int player_id, ChessResult* chess_result);
+
+/**
+ * chessEndTournaments: ends a group of tournaments, with the same results as calling chessEndTournament
+ *                      for each of them in order. The winners of the tournaments are calculated on several
+ *                      threads when there are enough players to rank, and are all set at the end.
+ *
+ * @param chess - the chess system. Must be non-NULL.
+ * @param tournament_ids - the ids of the tournaments to end. Must be non-NULL if n is positive.
+ * @param n - the number of ids.
+ * @param results - an array of n results, to which the result of ending each tournament is written,
+ *                  as chessEndTournament would return it. May be NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or tournament_ids are NULL. No tournament is ended.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed. No tournament is ended.
+ *     the first result that is not CHESS_SUCCESS, if there is one. The other tournaments are still ended.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessResult chessEndTournaments(ChessSystem chess, const int* tournament_ids, int n, ChessResult* results);
+
+/**
+ * chessAddGames: adds a batch of games, with the same results as calling chessAddGame for each of them in order.
+ *                Consecutive games of the same tournament share one lookup of it and room is made for them at
+ *                once, each player and participance is looked up once per game for both its validation and its
+ *                update, and every player of the batch is moved in the leaderboard once, after the last game.
+ *
+ * @param chess - the chess system. Must be non-NULL.
+ * @param records - the games to add. Must be non-NULL if n is positive.
+ * @param n - the number of games.
+ * @param results - an array of n results, to which the result of adding each game is written,
+ *                  as chessAddGame would return it. May be NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or records are NULL. No game is added.
+ *     the first result that is not CHESS_SUCCESS, if there is one. The other games are still added.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessResult chessAddGames(ChessSystem chess, const GameRecord* records, int n, ChessResult* results);
+
+/**
+ * chessImportResults: streams a text file of results into the chess system, adding its records in order.
+ *                     Every line is a record of one of the forms
+ *                         tournament_id, first_player, second_player, winner, play_time
+ *                         tournament_id, max_games_per_player, location
+ *                     which is added like chessAddGame or chessAddTournament, where winner is 0 for the first
+ *                     player, 1 for the second one and 2 for a draw. Fields may be surrounded by spaces or tabs,
+ *                     and empty lines are skipped. The file is read through a fixed buffer and its games are
+ *                     added with chessAddGames in batches of fixed size, so memory use doesn't grow with it.
+ *
+ * @param chess - the chess system. Must be non-NULL.
+ * @param path_file - the path of the file. Must be non-NULL.
+ * @param report - the report to write the counts of accepted and rejected records to. Must be non-NULL.
+ *                 A malformed line, or a line longer than the read buffer of 64KB, is a malformed record.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, path_file or report are NULL.
+ *     CHESS_SAVE_FAILURE - if the file couldn't be opened or read. The records before the failure are added.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed. The records that didn't fail are still added.
+ *     CHESS_SUCCESS - otherwise, even if records were rejected.
+ *
+ */
+ChessResult chessImportResults(ChessSystem chess, const char* path_file, ChessImportReport* report);
+
+/**
+ * chessViewCreate: takes a frozen view of the levels of the players and the statistics of the ended tournaments
+ *                  of the chess system, which chessViewSavePlayersLevels and chessViewSaveTournamentStatistics
+ *                  save exactly as chessSavePlayersLevels and chessSaveTournamentStatistics would have saved them
+ *                  when the view was taken. Nothing is copied to take it: it shares the leaderboard of the system,
+ *                  which copies an entry it shares before changing it, and the statistics of the ended tournaments,
+ *                  which never change once made. It takes O(number of ended tournaments) time.
+ *                  The view may be saved and destroyed by any thread while other threads go on changing the system,
+ *                  even if the system isn't thread safe, and it may outlive the system.
+ *
+ * @param chess - the chess system.
+ * @param chess_result - pointer to write the result of the operation to.
+ *
+ * @return
+ * NULL if the operation failed, or the view otherwise.
+ * chess_result is set to:
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessView chessViewCreate(ChessSystem chess, ChessResult* chess_result);
+
+/**
+ * chessViewDestroy: frees a view, and the entries only it still shares. Does nothing if view is NULL.
+ */
+void chessViewDestroy(ChessView view);
+
+/**
+ * chessViewSavePlayersLevels: saves the levels of the players of a view like chessSavePlayersLevels, with the sync
+ *                             policy the system had when the view was taken.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if view is NULL.
+ *     CHESS_SAVE_FAILURE - if writing to the file failed.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessResult chessViewSavePlayersLevels(ChessView view, FILE* file);
+
+/**
+ * chessViewSaveTournamentStatistics: saves the statistics of the ended tournaments of a view like
+ *                                    chessSaveTournamentStatistics.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if view is NULL.
+ *     CHESS_NO_TOURNAMENTS_ENDED - if no tournament had ended when the view was taken.
+ *     CHESS_SAVE_FAILURE - if the file couldn't be written.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessResult chessViewSaveTournamentStatistics(ChessView view, char* path_file);
+
+/**
+ * chessSetSyncPolicy: sets how chessSaveTournamentStatistics and chessSavePlayersLevels finish a save.
+ *                     With CHESS_SYNC_NONE, the default, the data is left to the operating system once written.
+ *                     With CHESS_SYNC_ON_SAVE, a save returns CHESS_SUCCESS only after the file was flushed
+ *                     and synced to the disk, and CHESS_SAVE_FAILURE if that failed.
+ *                     The policy also applies to every group of records the journal of the system writes.
+ *
+ * @param chess - the chess system. Must be non-NULL.
+ * @param sync_policy - the policy used by the following saves.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessResult chessSetSyncPolicy(ChessSystem chess, ChessSyncPolicy sync_policy);
+
+/**
+ * chessSaveSnapshot: saves the whole state of the chess system to a binary file, which chessLoadSnapshot
+ *                    loads much faster than the games could be added again. The file is written under
+ *                    a temporary name next to the given path, and replaces the file at the path only when
+ *                    it is complete. The sync policy of the system applies to it.
+ *
+ * @param chess - the chess system. Must be non-NULL.
+ * @param path_file - the path of the file to save to. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path_file are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if the file failed to be written. A file that was at the path is left as it was.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessResult chessSaveSnapshot(ChessSystem chess, const char* path_file);
+
+/**
+ * chessLoadSnapshot: creates a chess system in the state that was saved by chessSaveSnapshot.
+ *                    The file is mapped to memory and every map of the system is rebuilt from it at once.
+ *                    The new system has the default sync policy.
+ *
+ * @param path_file - the path of the snapshot. Must be non-NULL.
+ * @param chess_result - pointer to write the result of the operation to. May be NULL.
+ *
+ * @return
+ * NULL if the operation failed, or the new chess system otherwise.
+ * chess_result is set to:
+ *     CHESS_NULL_ARGUMENT - if path_file is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if the file couldn't be read, or isn't a complete snapshot of a supported version
+ *                          that was saved on a machine with the same byte order.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessSystem chessLoadSnapshot(const char* path_file, ChessResult* chess_result);
+
+/**
+ * chessJournalOpen: starts logging the changes made to the chess system to a journal file, which chessRecover
+ *                   replays. Every successful call of chessAddTournament, chessAddGame, chessRemovePlayer,
+ *                   chessRemoveTournament, chessEndTournament and chessEndTournaments appends a record.
+ *                   Records are written in groups of group_size, so a group shares one write and, with the
+ *                   CHESS_SYNC_ON_SAVE sync policy, one sync. The records of a group that wasn't written yet
+ *                   are lost if the process crashes. A journal that was already open is closed first.
+ *                   Recover a journal file before opening it again, so new records follow complete ones.
+ *
+ * @param chess - the chess system. Must be non-NULL.
+ * @param path_file - the path of the journal file, which is created if it doesn't exist. Must be non-NULL.
+ * @param group_size - the number of records written together. 1 writes every record once it's made.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path_file are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if the file couldn't be opened or written, or isn't a journal.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessResult chessJournalOpen(ChessSystem chess, const char* path_file, int group_size);
+
+/**
+ * chessJournalCommit: writes the records of the journal of the chess system that weren't written yet,
+ *                     without waiting for their group to fill.
+ *
+ * @param chess - the chess system. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_SAVE_FAILURE - if a record of the journal failed to be written since it was opened.
+ *                          No records are written after such a failure.
+ *     CHESS_SUCCESS - otherwise, or if no journal is open.
+ *
+ */
+ChessResult chessJournalCommit(ChessSystem chess);
+
+/**
+ * chessJournalClose: commits the journal of the chess system and stops logging changes.
+ *                    chessDestroy closes the journal as well.
+ *
+ * @param chess - the chess system. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_SAVE_FAILURE - if a record of the journal failed to be written since it was opened.
+ *     CHESS_SUCCESS - otherwise, or if no journal is open.
+ *
+ */
+ChessResult chessJournalClose(ChessSystem chess);
+
+/**
+ * chessRecover: makes again on the chess system the calls logged in a journal file, in the order they were made.
+ *               Records at the end of the file that weren't completely written by a crash are cut off the file.
+ *               To recover a system, replay the journal on a new system, or on the system loaded by
+ *               chessLoadSnapshot from a snapshot that was saved when the journal was started.
+ *               The calls made by the recovery aren't logged.
+ *
+ * @param chess - the chess system. Must be non-NULL.
+ * @param path_file - the path of the journal file. Must be non-NULL.
+ * @param chess_result - pointer to write the result of the operation to. May be NULL.
+ *
+ * @return
+ * the number of records that were replayed.
+ * chess_result is set to:
+ *     CHESS_NULL_ARGUMENT - if chess or path_file are NULL.
+ *     CHESS_OUT_OF_MEMORY - if a replayed call ran out of memory. The records after it aren't replayed.
+ *     CHESS_SAVE_FAILURE - if the file couldn't be read or cut, or isn't a journal of a supported version.
+ *     CHESS_SUCCESS - otherwise, or if the file doesn't exist.
+ *
+ */
+int chessRecover(ChessSystem chess, const char* path_file, ChessResult* chess_result);
+
+/**
+ * chessSetThreadSafe: sets whether the functions of a chess system may be called by several threads at once.
+ *                     In a thread safe system chessAddGame calls of different tournaments and different players
+ *                     run at the same time, and so do chessEndTournament, chessCalculateAveragePlayTime,
+ *                     chessGetPlayerLevel and chessJournalCommit. The last two read the results of a player
+ *                     while his games change them, without a lock. Every other function runs alone, and finishes the moves in the
+ *                     leaderboard that the games before it left for later.
+ *                     A game of a new player runs alone too, since it adds the player to the system.
+ *                     chessImportResults and chessRecover add their records through these functions.
+ *                     This function itself, chessRecover and chessDestroy must be called while no other
+ *                     thread uses the system.
+ *
+ * @param chess - the chess system.
+ * @param is_thread_safe - true to make the system thread safe, false to stop it from being thread safe.
+ *
+ * @return
+ * CHESS_NULL_ARGUMENT - if chess is NULL.
+ * CHESS_OUT_OF_MEMORY - if the locks couldn't be allocated. The system is left as it was.
+ * CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessResult chessSetThreadSafe(ChessSystem chess, bool is_thread_safe);
+
+/**
+ * chessStartQueue: starts a thread of the chess system that applies the commands queued by chessQueueAddGame
+ *                  and the other chessQueue functions, so the threads that queue them don't wait for them to be
+ *                  validated and applied. The commands are kept in a ring of fixed capacity, which any number of
+ *                  threads may queue to at once without a lock, and are applied in the order they were queued,
+ *                  in batches. The games of a batch that follow each other are added with one chessAddGames.
+ *                  A thread that queues a command to a full ring waits for the ring to have room.
+ *                  Only the thread of the queue calls the other functions of the system, unless the system is
+ *                  thread safe (chessSetThreadSafe). This function, chessStopQueue and chessDestroy must be called
+ *                  while no other thread uses the system. Does nothing if the queue is already started.
+ *
+ * @param chess - the chess system.
+ * @param capacity - the number of commands the queue holds at most, rounded up to a power of 2.
+ *
+ * @return
+ * CHESS_NULL_ARGUMENT - if chess is NULL.
+ * CHESS_OUT_OF_MEMORY - if the queue couldn't be allocated or its thread couldn't be started.
+ * CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessResult chessStartQueue(ChessSystem chess, int capacity);
+
+/**
+ * chessStopQueue: applies the commands that are left in the queue of the chess system and stops its thread.
+ *                 The chessQueue functions apply their commands at once from then on. chessDestroy stops the
+ *                 queue too. Does nothing if the queue isn't started.
+ *
+ * @return
+ * CHESS_NULL_ARGUMENT - if chess is NULL.
+ * CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessResult chessStopQueue(ChessSystem chess);
+
+/**
+ * chessFlushQueue: waits until every command the calling thread queued before is applied, and its callback
+ *                  returned. Unlike chessStopQueue, other threads may go on queueing meanwhile.
+ *
+ * @return
+ * CHESS_NULL_ARGUMENT - if chess is NULL.
+ * CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessResult chessFlushQueue(ChessSystem chess);
+
+/**
+ * chessQueueAddGame: queues a game to be added like chessAddGame by the thread of the queue, or adds it at once
+ *                    if the queue isn't started. chessQueueAddTournament, chessQueueRemoveTournament,
+ *                    chessQueueEndTournament and chessQueueRemovePlayer queue the other commands the same way,
+ *                    with the arguments of the functions they are named after.
+ *
+ * @param chess - the chess system.
+ * @param done - the function to call with the result of the game, as chessAddGame would return it.
+ *               It's called from the thread of the queue, which applies no other command until it returns,
+ *               so it should be short. May be NULL.
+ * @param context - passed as is to done.
+ *
+ * @return
+ * CHESS_NULL_ARGUMENT - if chess is NULL. done isn't called.
+ * CHESS_OUT_OF_MEMORY - if the command couldn't be allocated. done isn't called. Only the location of
+ *                       chessQueueAddTournament is allocated.
+ * CHESS_SUCCESS - otherwise. The result of the command is given to done.
+ *
+ */
+ChessResult chessQueueAddGame(ChessSystem chess, int tournament_id, int first_player, int second_player,
+                              Winner winner, int play_time, ChessCallback done, void* context);
+
+ChessResult chessQueueAddTournament(ChessSystem chess, int tournament_id, int max_games_per_player,
+                                    const char* tournament_location, ChessCallback done, void* context);
+
+ChessResult chessQueueRemoveTournament(ChessSystem chess, int tournament_id, ChessCallback done, void* context);
+
+ChessResult chessQueueEndTournament(ChessSystem chess, int tournament_id, ChessCallback done, void* context);
+
+ChessResult chessQueueRemovePlayer(ChessSystem chess, int player_id, ChessCallback done, void* context);
+
+/**
+ * chessGetMetrics: gives the counts of the calls of the chess system functions listed by ChessApi and of the
+ *                  work done by its maps, since the start of the process or the last chessResetMetrics.
+ *                  They are only kept when the system is built with -DCHESS_METRICS, and the calls are only timed
+ *                  with -DCHESS_METRICS_TIMERS as well. Otherwise the functions do no extra work at all.
+ *                  The counts cover every chess system of the process, and calls made from several threads.
+ *
+ * @param metrics - the counts to write. Must be non-NULL.
+ *
+ * @return
+ * CHESS_NULL_ARGUMENT - if metrics is NULL.
+ * CHESS_SUCCESS - otherwise, even if nothing is counted.
+ *
+ */
+ChessResult chessGetMetrics(ChessMetrics* metrics);
+
+/**
+ * chessResetMetrics: sets every count given by chessGetMetrics back to 0.
+ */
+void chessResetMetrics(void);
+
+/**
+ * chessPrintMetrics: prints counts given by chessGetMetrics as text, one line for the maps and a few lines for
+ *                    every function that was called. The percentiles of the latencies are the ends of the buckets
+ *                    of the histograms they fall in.
+ *
+ * @param metrics - the counts to print. Must be non-NULL.
+ * @param file - the file to print to. Must be non-NULL.
+ *
+ * @return
+ * CHESS_NULL_ARGUMENT - if metrics or file are NULL.
+ * CHESS_SAVE_FAILURE - if writing to the file failed.
+ * CHESS_SUCCESS - otherwise.
+ *
+ */
+ChessResult chessPrintMetrics(const ChessMetrics* metrics, FILE* file);
+
+#endif //_CHESSSYSTEM_EXTENSIONS_H
@@ -0,0 +1,295 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+#include "commandQueue.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#define MIN_CAPACITY 2
+#define BATCH_SIZE 256
+#define CACHE_LINE_SIZE 64
+
+// the sequence of a slot is its position while it's free for the push to that position, the position + 1 once
+// it holds the command pushed there, and the position + capacity once the applier took the command, which is
+// the position of the next push to the slot
+typedef struct {
+    unsigned long sequence;
+    Command command;
+} Slot;
+
+// the pushers race for the tail while the applier moves the head, so they take a cache line each
+typedef union {
+    unsigned long position;
+    char padding[CACHE_LINE_SIZE];
+} Position;
+
+struct command_queue_t {
+    Position tail;
+    Position head;
+    Slot* slots;
+    unsigned long mask;
+    ChessSystem chess;
+    // the commands the applier took from the ring, and the games and results of their runs of games
+    Command batch[BATCH_SIZE];
+    GameRecord games[BATCH_SIZE];
+    ChessResult results[BATCH_SIZE];
+    pthread_t applier;
+    // only taken to sleep while there is nothing to do, and to wake the sleepers up
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    bool is_applier_waiting;
+    int waiting_pushers;
+    bool is_stopping;
+};
+
+static Slot* slotAt(CommandQueue queue, unsigned long position) {
+    return &queue->slots[position & queue->mask];
+}
+
+// whether the command the applier expects next was pushed. a sleeper checks its condition and a waker changes it
+// with sequentially consistent operations, on both sides of the flag that tells the waker there is a sleeper,
+// so either the sleeper sees the change or the waker sees the flag
+static bool hasCommand(CommandQueue queue) {
+    unsigned long head = queue->head.position;
+    return __atomic_load_n(&slotAt(queue, head)->sequence, __ATOMIC_SEQ_CST) == head + 1;
+}
+
+static bool hasRoom(Slot* slot, unsigned long position) {
+    return (long)(__atomic_load_n(&slot->sequence, __ATOMIC_SEQ_CST) - position) >= 0;
+}
+
+static void wakeApplier(CommandQueue queue) {
+    if (__atomic_load_n(&queue->is_applier_waiting, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&queue->mutex);
+        pthread_cond_signal(&queue->not_empty);
+        pthread_mutex_unlock(&queue->mutex);
+    }
+}
+
+static void wakePushers(CommandQueue queue) {
+    if (__atomic_load_n(&queue->waiting_pushers, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&queue->mutex);
+        pthread_cond_broadcast(&queue->not_full);
+        pthread_mutex_unlock(&queue->mutex);
+    }
+}
+
+// sleeps until a command is pushed, or the queue is stopped. returns false if it was stopped and is empty
+static bool waitForCommand(CommandQueue queue) {
+    pthread_mutex_lock(&queue->mutex);
+    __atomic_store_n(&queue->is_applier_waiting, true, __ATOMIC_SEQ_CST);
+    bool has_command;
+    while (!(has_command = hasCommand(queue)) && !queue->is_stopping) {
+        pthread_cond_wait(&queue->not_empty, &queue->mutex);
+    }
+    __atomic_store_n(&queue->is_applier_waiting, false, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&queue->mutex);
+    return has_command;
+}
+
+// sleeps until the applier frees the slot of a push
+static void waitForRoom(CommandQueue queue, Slot* slot, unsigned long position) {
+    pthread_mutex_lock(&queue->mutex);
+    __atomic_fetch_add(&queue->waiting_pushers, 1, __ATOMIC_SEQ_CST);
+    while (!hasRoom(slot, position)) {
+        pthread_cond_wait(&queue->not_full, &queue->mutex);
+    }
+    __atomic_fetch_sub(&queue->waiting_pushers, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+void commandQueuePush(CommandQueue queue, const Command* command) {
+    unsigned long position = __atomic_load_n(&queue->tail.position, __ATOMIC_RELAXED);
+    while (true) {
+        Slot* slot = slotAt(queue, position);
+        long difference = (long)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - position);
+        if (difference == 0) {
+            // on failure the position is reloaded with the tail another pusher moved
+            if (__atomic_compare_exchange_n(&queue->tail.position, &position, position + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                slot->command = *command;
+                __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_SEQ_CST);
+                wakeApplier(queue);
+                return;
+            }
+            continue;
+        }
+        // the slot still holds the command of the previous round, so the ring is full
+        if (difference < 0) {
+            waitForRoom(queue, slot, position);
+        }
+        position = __atomic_load_n(&queue->tail.position, __ATOMIC_RELAXED);
+    }
+}
+
+// moves the commands that are ready from the ring to the batch, and frees their slots for the pushers
+static int takeCommands(CommandQueue queue) {
+    int count = 0;
+    unsigned long head = queue->head.position;
+    while (count < BATCH_SIZE) {
+        Slot* slot = slotAt(queue, head);
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != head + 1) {
+            break;
+        }
+        queue->batch[count++] = slot->command;
+        __atomic_store_n(&slot->sequence, head + queue->mask + 1, __ATOMIC_SEQ_CST);
+        head++;
+    }
+    queue->head.position = head;
+    return count;
+}
+
+ChessResult commandApply(ChessSystem chess, Command* command) {
+    ChessResult result = CHESS_SUCCESS;
+    GameRecord* game = &command->game;
+    switch (command->type) {
+        case COMMAND_ADD_TOURNAMENT:
+            result = chessAddTournament(chess, game->tournament_id, command->max_games_per_player,
+                                        command->location);
+            break;
+        case COMMAND_REMOVE_TOURNAMENT:
+            result = chessRemoveTournament(chess, game->tournament_id);
+            break;
+        case COMMAND_END_TOURNAMENT:
+            result = chessEndTournament(chess, game->tournament_id);
+            break;
+        case COMMAND_ADD_GAME:
+            result = chessAddGame(chess, game->tournament_id, game->first_player, game->second_player,
+                                  game->winner, game->play_time);
+            break;
+        case COMMAND_REMOVE_PLAYER:
+            result = chessRemovePlayer(chess, command->player_id);
+            break;
+        case COMMAND_NONE:
+            break;
+    }
+    free(command->location);
+    command->location = NULL;
+    if (command->done != NULL) {
+        command->done(result, command->context);
+    }
+    return result;
+}
+
+// applies the commands of the batch in order, every run of games with one call of chessAddGames
+static void applyCommands(CommandQueue queue, int count) {
+    int i = 0;
+    while (i < count) {
+        if (queue->batch[i].type != COMMAND_ADD_GAME) {
+            commandApply(queue->chess, &queue->batch[i++]);
+            continue;
+        }
+        int first = i;
+        for (; i < count && queue->batch[i].type == COMMAND_ADD_GAME; i++) {
+            queue->games[i - first] = queue->batch[i].game;
+        }
+        chessAddGames(queue->chess, queue->games, i - first, queue->results);
+        for (int j = first; j < i; j++) {
+            if (queue->batch[j].done != NULL) {
+                queue->batch[j].done(queue->results[j - first], queue->batch[j].context);
+            }
+        }
+    }
+}
+
+static void* runApplier(void* context) {
+    CommandQueue queue = context;
+    while (true) {
+        int count = takeCommands(queue);
+        if (count == 0) {
+            if (!waitForCommand(queue)) {
+                return NULL;
+            }
+            continue;
+        }
+        wakePushers(queue);
+        applyCommands(queue, count);
+    }
+}
+
+CommandQueue commandQueueCreate(ChessSystem chess, int capacity) {
+    unsigned long slots_num = MIN_CAPACITY;
+    while (slots_num < (unsigned long)capacity) {
+        slots_num *= 2;
+    }
+    CommandQueue queue = malloc(sizeof(*queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    queue->slots = malloc(sizeof(*queue->slots) * slots_num);
+    if (queue->slots == NULL) {
+        free(queue);
+        return NULL;
+    }
+    for (unsigned long i = 0; i < slots_num; i++) {
+        queue->slots[i].sequence = i;
+    }
+    queue->mask = slots_num - 1;
+    queue->tail.position = 0;
+    queue->head.position = 0;
+    queue->chess = chess;
+    queue->is_applier_waiting = false;
+    queue->waiting_pushers = 0;
+    queue->is_stopping = false;
+    pthread_mutex_init(&queue->mutex, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+    pthread_cond_init(&queue->not_full, NULL);
+    if (pthread_create(&queue->applier, NULL, runApplier, queue) != 0) {
+        pthread_cond_destroy(&queue->not_full);
+        pthread_cond_destroy(&queue->not_empty);
+        pthread_mutex_destroy(&queue->mutex);
+        free(queue->slots);
+        free(queue);
+        return NULL;
+    }
+    return queue;
+}
+
+void commandQueueDestroy(CommandQueue queue) {
+    if (queue == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&queue->mutex);
+    queue->is_stopping = true;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->mutex);
+    pthread_join(queue->applier, NULL);
+    pthread_cond_destroy(&queue->not_full);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_mutex_destroy(&queue->mutex);
+    free(queue->slots);
+    free(queue);
+}
+
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t applied;
+    bool is_applied;
+} Flush;
+
+static void finishFlush(ChessResult result, void* context) {
+    Flush* flush = context;
+    pthread_mutex_lock(&flush->mutex);
+    flush->is_applied = true;
+    pthread_cond_signal(&flush->applied);
+    pthread_mutex_unlock(&flush->mutex);
+}
+
+void commandQueueFlush(CommandQueue queue) {
+    Flush flush = { .is_applied = false };
+    pthread_mutex_init(&flush.mutex, NULL);
+    pthread_cond_init(&flush.applied, NULL);
+    Command command = { .type = COMMAND_NONE, .location = NULL, .done = finishFlush, .context = &flush };
+    commandQueuePush(queue, &command);
+    pthread_mutex_lock(&flush.mutex);
+    while (!flush.is_applied) {
+        pthread_cond_wait(&flush.applied, &flush.mutex);
+    }
+    pthread_mutex_unlock(&flush.mutex);
+    pthread_cond_destroy(&flush.applied);
+    pthread_mutex_destroy(&flush.mutex);
+}
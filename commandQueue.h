@@ -0,0 +1,78 @@
+#ifndef _COMMAND_QUEUE_H
+#define _COMMAND_QUEUE_H
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+
+/**
+ * Type for a bounded queue of commands to a chess system, which any number of threads push to, and one thread
+ * of the queue applies to the system in the order they were pushed. The commands are kept in a ring of slots,
+ * and every slot has a sequence number that tells whether it's free for the push with a given position or holds
+ * the command the applier expects next, so pushers only race for the tail of the ring with one compare and swap,
+ * and wait only when the ring is full. The applier takes the ready commands in batches, frees their slots at
+ * once, adds runs of games with chessAddGames and then calls the callbacks of the commands with their results.
+ */
+typedef struct command_queue_t* CommandQueue;
+
+/** The kinds of commands */
+typedef enum {
+    COMMAND_ADD_TOURNAMENT,
+    COMMAND_REMOVE_TOURNAMENT,
+    COMMAND_END_TOURNAMENT,
+    COMMAND_ADD_GAME,
+    COMMAND_REMOVE_PLAYER,
+    // does nothing, and is only pushed for its callback
+    COMMAND_NONE
+} CommandType;
+
+/** A command, with the arguments of the function of its type */
+typedef struct {
+    CommandType type;
+    // the game of COMMAND_ADD_GAME, and the tournament id of the tournament commands
+    GameRecord game;
+    int max_games_per_player;
+    char* location; // owned by the command
+    int player_id;
+    ChessCallback done; // may be NULL
+    void* context;
+} Command;
+
+
+/**
+ * commandQueueCreate: allocates a queue and starts the thread that applies its commands.
+ *
+ * @param chess - the chess system to apply the commands to.
+ * @param capacity - the number of commands the queue holds at most, rounded up to a power of 2.
+ *
+ * @return
+ * NULL if an allocation failed or the thread couldn't be started, or the new queue otherwise.
+ */
+CommandQueue commandQueueCreate(ChessSystem chess, int capacity);
+
+/**
+ * commandQueueDestroy: applies the commands that are left in a queue, stops its thread and deallocates it.
+ *                      No thread may push to the queue meanwhile. Does nothing if queue is NULL.
+ */
+void commandQueueDestroy(CommandQueue queue);
+
+/**
+ * commandQueuePush: adds a command to the end of a queue, waiting while the queue is full.
+ *                   The queue owns the location of the command from now on.
+ */
+void commandQueuePush(CommandQueue queue, const Command* command);
+
+/**
+ * commandQueueFlush: waits until every command pushed to a queue before the call is applied and its callback
+ *                    returned.
+ */
+void commandQueueFlush(CommandQueue queue);
+
+/**
+ * commandApply: applies one command to a chess system, calls its callback with the result and frees its location.
+ *
+ * @return
+ * the result of the command.
+ */
+ChessResult commandApply(ChessSystem chess, Command* command);
+
+#endif //_COMMAND_QUEUE_H
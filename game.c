@@ -1,5 +1,11 @@
 #include "chessSystem.h"
 #include "map.h"
+#include "mapExtensions.h"
+#include "pool.h"
+#include "pairSet.h"
+#include "leaderboard.h"
+#include "rankTable.h"
+#include "parallel.h"
 #include "tournament.h"
 #include "game.h"
 #include "player.h"
@@ -11,24 +17,21 @@
 #include <stdbool.h>
 
 struct games_t{
-    int* game_id;
+    int game_id;
     int first_player;
     int second_player;
     Winner winner;
     double play_time;
+    Pool pool;
 };
 
-Game gameCreate(int id, int first_player, int second_player, Winner winner, double play_time) {
-    Game game = malloc(sizeof(*game));
+Game gameCreate(Pool pool, int id, int first_player, int second_player, Winner winner, double play_time) {
+    Game game = poolAlloc(pool);
     if(game == NULL)
         return NULL;
 
-    game->game_id = malloc(sizeof(*(game->game_id)));
-    if (game->game_id == NULL) {
-        free(game);
-        return NULL;
-    }
-    *(game->game_id) = id;
+    game->pool = pool;
+    game->game_id = id;
     game->first_player = first_player;
     game->second_player = second_player;
     game->winner = winner;
@@ -37,29 +40,31 @@ Game gameCreate(int id, int first_player, int second_player, Winner winner, doub
 }
 
 MapDataElement gameCopy(MapDataElement game_to_copy) {
-    Game new_game = malloc(sizeof(*new_game));
+    Game game = game_to_copy;
+    return gameCopyToPool(game, game->pool);
+}
+
+Game gameCopyToPool(Game game, Pool pool) {
+    Game new_game = poolAlloc(pool);
     if (new_game == NULL)
         return NULL;
-        
-    new_game->game_id = malloc(sizeof(*(new_game->game_id)));
-    if (new_game->game_id == NULL) {
-        free(new_game);
-        return NULL;
-    }
-    Game game = game_to_copy;
 
-    *(new_game->game_id) = *(game->game_id);
+    new_game->pool = pool;
+    new_game->game_id = game->game_id;
     new_game->first_player = game->first_player;
     new_game->second_player = game->second_player;
     new_game->winner = game->winner;
     new_game->play_time = game->play_time;
-    return (MapDataElement)new_game; 
+    return new_game;
 }
 
 void gameDestroy(MapDataElement generic_game) {
     Game game = generic_game;
-    free(game->game_id);
-    free(game);
+    poolFree(game->pool, game);
+}
+
+Pool gamePoolCreate() {
+    return poolCreate(sizeof(struct games_t));
 }
 
 // checks wether a given id is valid or not.
@@ -69,34 +74,9 @@ static bool idValidate(int id) {
     return false;
 }
 
-// checks wether a given plaer is in the chess system or not.
-static bool isPlayerInSystem(Map players, int player_id) {
-    if(mapContains(players, &player_id))
-        return true;
-    return false;
-}
-
-// checks if a pair of players had played together in a given tournament or not.
-static bool checkIfPlayersPlayedTogether(Tournament tournament, int first_player, int second_player) {
-    Map games = tournamentGetGames(tournament);
-    Game curr_game;
-    int original_first_player;
-    int original_second_player;
-    MAP_FOREACH(int*, game_iter, games){
-        curr_game = mapGet(games, game_iter);
-        original_first_player = curr_game->first_player;
-        original_second_player = curr_game->second_player;
-        if((first_player == original_first_player && second_player == original_second_player) ||
-           (first_player == original_second_player && second_player == original_first_player)){
-               return true;
-           }
-    free(game_iter);
-    }
-    return false;
-}
 
-ChessResult gameDataValidate(Map tournaments, Map players, int tournament_id, int first_player,
-                            int second_player, int play_time) {
+ChessResult gameDataValidate(Tournament tournament, Map players, int tournament_id, int first_player,
+                            int second_player, int play_time, Player* game_players, Participance* participances) {
     if(players == NULL)
         return CHESS_NULL_ARGUMENT;
 
@@ -106,25 +86,24 @@ ChessResult gameDataValidate(Map tournaments, Map players, int tournament_id, in
     if(first_player == second_player)
         return CHESS_INVALID_ID;
 
-    if(!mapContains(tournaments, &tournament_id))
+    if(tournament == NULL)
         return CHESS_TOURNAMENT_NOT_EXIST;
 
-    Tournament tournament = mapGet(tournaments, &tournament_id);
     if(tournamentCheckIfEnded(tournament) == true)
         return CHESS_TOURNAMENT_ENDED;
 
-    if((isPlayerInSystem(players, first_player)) && (isPlayerInSystem(players, second_player))){
-        if(checkIfPlayersPlayedTogether(tournament, first_player, second_player)){
-            return CHESS_GAME_ALREADY_EXISTS;
-        }
+    // pairs that include a removed player are no longer in the set
+    if(pairSetContains(tournamentGetPlayedPairs(tournament), first_player, second_player)){
+        return CHESS_GAME_ALREADY_EXISTS;
     }
 
     if(play_time < 0)
         return CHESS_INVALID_PLAY_TIME;
 
-    int max_games_for_player = tournamentGetMaxGamesForPlayer(tournament);
-    ChessResult res1 = playerCheckIfCanPlayInTournament(players, first_player, tournament_id, max_games_for_player);
-    ChessResult res2 = playerCheckIfCanPlayInTournament(players, second_player, tournament_id, max_games_for_player);
+    ChessResult res1 = playerCheckIfCanPlayInTournament(players, first_player, tournament,
+                                                        &game_players[0], &participances[0]);
+    ChessResult res2 = playerCheckIfCanPlayInTournament(players, second_player, tournament,
+                                                        &game_players[1], &participances[1]);
 
     if((res1 == CHESS_SUCCESS) && (res2 == CHESS_SUCCESS)){
         return CHESS_SUCCESS;
@@ -137,8 +116,7 @@ ChessResult gameDataValidate(Map tournaments, Map players, int tournament_id, in
     }    
 }
 
-int gameMakeId(Map tournaments, int tournament_id)  {
-    Tournament tournament = mapGet(tournaments, &tournament_id);
+int gameMakeId(Tournament tournament)  {
     Map games = tournamentGetGames(tournament);
     int size = mapGetSize(games);
     return size+1;
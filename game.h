@@ -3,13 +3,23 @@
 
 
 #include <stdio.h>
+#include "player.h"
 
 typedef struct games_t *Game;
 
 
 /**
- * gameCreate: allocates a new participance for a certain player.
+ * gamePoolCreate: allocates a new empty pool to allocate the games of a tournament from.
+ *
+ * @return NULL if the allocation failed, or the new pool otherwise.
+ *
+ */
+Pool gamePoolCreate();
+
+/**
+ * gameCreate: allocates a new game in a given pool.
  * 
+ * @param pool - the pool of games of the tournament the game belongs to. Must be created with gamePoolCreate.
  * @param id - the new game's id.
  * @param first_player - the id of the first player in the game.
  * @param second_player - the id of the second player in the game.
@@ -19,10 +29,10 @@ typedef struct games_t *Game;
  * @return NULL if the allocation failed, or a pointer to the new game that was created otherwise.
  *
  */
-Game gameCreate(int id, int first_player, int second_player, Winner winner, double play_time);
+Game gameCreate(Pool pool, int id, int first_player, int second_player, Winner winner, double play_time);
 
 /**
- * gameCopy: duplicate a given game - allocate a new one and copy the data.
+ * gameCopy: duplicate a given game - allocate a new one from the same pool and copy the data.
  *
  * @param game_to_copy - the game that is copied. Must be non-NULL.
  * 
@@ -32,8 +42,20 @@ Game gameCreate(int id, int first_player, int second_player, Winner winner, doub
  */
 MapDataElement gameCopy(MapDataElement game_to_copy);
 
+/**
+ * gameCopyToPool: duplicate a given game into another pool, such as the pool of a copied tournament.
+ *
+ * @param game - the game that is copied. Must be non-NULL.
+ * @param pool - the pool the new game is allocated from.
+ *
+ * @return NULL if the allocation of the new game failed,
+ *         or a pointer to the new game that was created otherwise.
+ *
+ */
+Game gameCopyToPool(Game game, Pool pool);
+
 /** 
- * gameDestroy: frees all resources of a game in a certain tournament.
+ * gameDestroy: returns a game in a certain tournament to the pool it was allocated from.
  * 
  * @param generic_game - points to the game that is being removed.
  * 
@@ -43,12 +65,17 @@ void gameDestroy(MapDataElement generic_game);
 /**
  * gameDataValidate: checks wether the data that is given for adding a new game is valid.
  * 
- * @param tournaments - the map of tournaments that containes the tournament in question.
+ * @param tournament - the tournament to which the new game is added to, as it was looked up by its id,
+ *                     or NULL if there is no tournament with the id.
  * @param players - the map of players that containes the players of the game that will be added.
  * @param tournament_id - the id of the tournament to which the new game is added to.
  * @param first_player - the id of the first player in the game.
  * @param second_player - the id of the first player in the game.
  * @param play_time - the given game's time.
+ * @param game_players - array of two, to write the first and the second player to when the data is valid.
+ *                       Players who are new to the system or the tournament are added to it by the check.
+ * @param participances - array of two, to write the participances of the players in the tournament to
+ *                        when the data is valid.
  * 
  * @return
  *     CHESS_NULL_ARGUMENT - if chess is NULL.
@@ -63,20 +90,19 @@ void gameDestroy(MapDataElement generic_game);
  *     CHESS_SUCCESS - if all data is valid.
  * 
  */
-ChessResult gameDataValidate(Map tournaments, Map players, int tournament_id, int first_player,
-                            int second_player, int play_time);
+ChessResult gameDataValidate(Tournament tournament, Map players, int tournament_id, int first_player,
+                            int second_player, int play_time, Player* game_players, Participance* participances);
 
 /**
  * gameMakeId: return a number that will be provided to a gime as his id.
  * 
- * @param tournaments - the map of tournaments that includes all games in the system.
- * @param tournament_id - the specific tournament to which we add the new game, that
- *                        will recieve the return id.
+ * @param tournament - the specific tournament to which we add the new game, that
+ *                     will recieve the return id.
  * 
  * @return an id.
  * 
  */
-int gameMakeId(Map tournaments, int tournament_id);
+int gameMakeId(Tournament tournament);
 
 /**
  * gameGetPlayTime: returns the game time.
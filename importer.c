@@ -0,0 +1,217 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+#include "importer.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+
+#define READ_BUFFER_SIZE (1 << 16)
+#define BATCH_SIZE 4096
+#define GAME_COMMAS 4
+#define TOURNAMENT_COMMAS 2
+
+typedef struct {
+    ChessSystem chess;
+    ChessImportReport* report;
+    bool is_out_of_memory;
+    // the games read since the last batch was added
+    GameRecord records[BATCH_SIZE];
+    ChessResult results[BATCH_SIZE];
+    int records_num;
+    // one more byte than is read, so the last line of the file can be terminated in place
+    char buffer[READ_BUFFER_SIZE + 1];
+} Importer;
+
+static void countResult(Importer* importer, ChessResult result) {
+    if (result == CHESS_SUCCESS) {
+        importer->report->accepted++;
+        return;
+    }
+    importer->report->rejected++;
+    importer->report->rejected_by_result[result]++;
+    if (result == CHESS_OUT_OF_MEMORY) {
+        importer->is_out_of_memory = true;
+    }
+}
+
+static void countMalformed(Importer* importer) {
+    importer->report->rejected++;
+    importer->report->malformed++;
+}
+
+static void addBatch(Importer* importer) {
+    chessAddGames(importer->chess, importer->records, importer->records_num, importer->results);
+    for (int i = 0; i < importer->records_num; i++) {
+        countResult(importer, importer->results[i]);
+    }
+    importer->records_num = 0;
+}
+
+static bool isBlank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+// parses an int field at a given position of a line, which ends at a comma or at the end of the line,
+// and moves the position past the comma. returns false if the field isn't an int.
+static bool parseInt(const char** position, const char* end, int* value) {
+    const char* current = *position;
+    while (current < end && isBlank(*current)) {
+        current++;
+    }
+    bool is_negative = current < end && *current == '-';
+    if (is_negative) {
+        current++;
+    }
+    if (current == end || *current < '0' || *current > '9') {
+        return false;
+    }
+    long long number = 0;
+    while (current < end && *current >= '0' && *current <= '9') {
+        number = number * 10 + (*current - '0');
+        if (number > (long long)INT_MAX + 1) {
+            return false;
+        }
+        current++;
+    }
+    number = is_negative ? -number : number;
+    if (number > INT_MAX) {
+        return false;
+    }
+    while (current < end && isBlank(*current)) {
+        current++;
+    }
+    if (current < end && *current++ != ',') {
+        return false;
+    }
+    *position = current;
+    *value = (int)number;
+    return true;
+}
+
+static void addGameLine(Importer* importer, const char* line, const char* end) {
+    int fields[GAME_COMMAS + 1];
+    for (int i = 0; i <= GAME_COMMAS; i++) {
+        if (!parseInt(&line, end, &fields[i])) {
+            countMalformed(importer);
+            return;
+        }
+    }
+    if (fields[3] < FIRST_PLAYER || fields[3] > DRAW) {
+        countMalformed(importer);
+        return;
+    }
+    GameRecord record = { fields[0], fields[1], fields[2], (Winner)fields[3], fields[4] };
+    importer->records[importer->records_num++] = record;
+    if (importer->records_num == BATCH_SIZE) {
+        addBatch(importer);
+    }
+}
+
+// the location is the rest of the line, which is terminated in place
+static void addTournamentLine(Importer* importer, char* line, char* end) {
+    int tournament_id, max_games_per_player;
+    const char* location = line;
+    if (!parseInt(&location, end, &tournament_id) || !parseInt(&location, end, &max_games_per_player)) {
+        countMalformed(importer);
+        return;
+    }
+    while (location < end && isBlank(*location)) {
+        location++;
+    }
+    *end = '\0';
+    // the games before the tournament are added first, so the records are added in the order of the file
+    addBatch(importer);
+    countResult(importer, chessAddTournament(importer->chess, tournament_id, max_games_per_player, location));
+}
+
+static void addLine(Importer* importer, char* line, char* end) {
+    while (end > line && (isBlank(end[-1]) || end[-1] == '\r')) {
+        end--;
+    }
+    while (line < end && isBlank(*line)) {
+        line++;
+    }
+    if (line == end) {
+        return;
+    }
+    int commas = 0;
+    for (const char* current = line; current < end; current++) {
+        commas += *current == ',';
+    }
+    if (commas == GAME_COMMAS) {
+        addGameLine(importer, line, end);
+    }
+    else if (commas == TOURNAMENT_COMMAS) {
+        addTournamentLine(importer, line, end);
+    }
+    else {
+        countMalformed(importer);
+    }
+}
+
+ChessResult importerRead(ChessSystem chess, int file, ChessImportReport* report) {
+    memset(report, 0, sizeof(*report));
+    Importer* importer = malloc(sizeof(*importer));
+    if (importer == NULL) {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    importer->chess = chess;
+    importer->report = report;
+    importer->is_out_of_memory = false;
+    importer->records_num = 0;
+
+    ChessResult result = CHESS_SUCCESS;
+    char* buffer = importer->buffer;
+    size_t kept = 0; // the size of the line at the end of the last read, which continues in the next one
+    bool is_skipping = false; // whether the rest of a line that doesn't fit in the buffer is skipped
+    while (true) {
+        ssize_t read_size = read(file, buffer + kept, READ_BUFFER_SIZE - kept);
+        if (read_size < 0 && errno == EINTR) {
+            continue;
+        }
+        if (read_size < 0) {
+            result = CHESS_SAVE_FAILURE;
+            break;
+        }
+        if (read_size == 0) {
+            break;
+        }
+        char* data_end = buffer + kept + read_size;
+        char* line = buffer;
+        char* newline;
+        while ((newline = memchr(line, '\n', data_end - line)) != NULL) {
+            if (!is_skipping) {
+                addLine(importer, line, newline);
+            }
+            is_skipping = false;
+            line = newline + 1;
+        }
+        kept = data_end - line;
+        if (kept == READ_BUFFER_SIZE) {
+            if (!is_skipping) {
+                countMalformed(importer);
+            }
+            is_skipping = true;
+            kept = 0;
+        }
+        else {
+            memmove(buffer, line, kept);
+        }
+    }
+    // the last line of a file may have no newline
+    if (result == CHESS_SUCCESS && kept > 0 && !is_skipping) {
+        addLine(importer, buffer, buffer + kept);
+    }
+    addBatch(importer);
+    if (result == CHESS_SUCCESS && importer->is_out_of_memory) {
+        result = CHESS_OUT_OF_MEMORY;
+    }
+    free(importer);
+    return result;
+}
@@ -0,0 +1,33 @@
+#ifndef _IMPORTER_H
+#define _IMPORTER_H
+
+/**
+ * The importer streams a text file of results into a chess system, through one read buffer and one batch of
+ * games of fixed sizes, so files of any length are imported in constant memory. Every line is a record:
+ *     tournament_id, first_player, second_player, winner, play_time   - a game, added like chessAddGame,
+ *                                                                      where winner is 0 for the first player,
+ *                                                                      1 for the second one and 2 for a draw.
+ *     tournament_id, max_games_per_player, location                   - a tournament, added like
+ *                                                                      chessAddTournament.
+ * Fields are separated by commas and may be surrounded by spaces or tabs. Empty lines are skipped, and lines
+ * may end with "\r\n".
+ */
+
+
+/**
+ * importerRead: reads a file of results to its end, and adds its records to a chess system in order.
+ *
+ * @param chess - the chess system to add the records to.
+ * @param file - a file descriptor open for reading. It isn't closed.
+ * @param report - the report to write the counts of the records to.
+ *
+ * @return
+ * CHESS_OUT_OF_MEMORY if the buffers couldn't be allocated, or a record failed because an allocation failed.
+ *                     The records after it are still added.
+ * CHESS_SAVE_FAILURE if reading the file failed. The records before the failure are added.
+ * CHESS_SUCCESS otherwise, even if some records were rejected.
+ *
+ */
+ChessResult importerRead(ChessSystem chess, int file, ChessImportReport* report);
+
+#endif //_IMPORTER_H
@@ -0,0 +1,357 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+#include "checksum.h"
+#include "journal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define JOURNAL_MAGIC "CHESSJNL"
+#define MAGIC_SIZE 8
+#define JOURNAL_VERSION 1
+#define BYTE_ORDER_MARK UINT32_C(0x01020304)
+#define FILE_MODE 0666
+#define INITIAL_BUFFER_SIZE 4096
+// a record is its frame, followed by a payload of a type and the arguments of the logged call
+#define FRAME_SIZE (2 * sizeof(uint32_t))
+#define FIELD_SIZE sizeof(int32_t)
+#define MAX_FIELDS 6
+
+typedef struct {
+    char magic[MAGIC_SIZE];
+    uint32_t version;
+    uint32_t byte_order;
+} JournalHeader;
+
+// the size of the payload, and the low half of its checksum folded onto the high half
+typedef struct {
+    uint32_t payload_size;
+    uint32_t checksum;
+} Frame;
+
+typedef enum {
+    RECORD_ADD_TOURNAMENT = 1, // followed by the location, without its null terminator
+    RECORD_ADD_GAME,
+    RECORD_REMOVE_PLAYER,
+    RECORD_REMOVE_TOURNAMENT,
+    RECORD_END_TOURNAMENT
+} RecordType;
+
+struct journal_t {
+    int file;
+    unsigned char* buffer; // the records of the group that weren't written yet
+    size_t size;
+    size_t capacity;
+    int records_num;
+    int group_size;
+    ChessSyncPolicy sync_policy;
+    bool is_synced;
+    bool is_failed;
+    // records are logged by calls that run at the same time when the system is thread safe
+    pthread_mutex_t lock;
+};
+
+static uint32_t payloadChecksum(const void* payload, size_t size) {
+    Checksum checksum;
+    checksumStart(&checksum);
+    checksumAdd(&checksum, payload, size);
+    uint64_t hash = checksumEnd(&checksum);
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+static bool writeAll(int file, const void* data, size_t size) {
+    const unsigned char* bytes = data;
+    while (size > 0) {
+        ssize_t written = write(file, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+static void setHeader(JournalHeader* header) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, JOURNAL_MAGIC, MAGIC_SIZE);
+    header->version = JOURNAL_VERSION;
+    header->byte_order = BYTE_ORDER_MARK;
+}
+
+static bool isValidHeader(const JournalHeader* header) {
+    JournalHeader expected;
+    setHeader(&expected);
+    return memcmp(header, &expected, sizeof(expected)) == 0;
+}
+
+// a new file gets a header, and an existing one must start with a complete header
+static bool prepareFile(int file, ChessSyncPolicy sync_policy) {
+    struct stat file_status;
+    if (fstat(file, &file_status) != 0) {
+        return false;
+    }
+    JournalHeader header;
+    if (file_status.st_size == 0) {
+        setHeader(&header);
+        return writeAll(file, &header, sizeof(header)) && (sync_policy == CHESS_SYNC_NONE || fsync(file) == 0);
+    }
+    // the file is opened for appending, so reading still starts at its beginning
+    return read(file, &header, sizeof(header)) == sizeof(header) && isValidHeader(&header);
+}
+
+Journal journalOpen(const char* path_file, int group_size, ChessSyncPolicy sync_policy, ChessResult* chess_result) {
+    Journal journal = malloc(sizeof(*journal));
+    if (journal == NULL) {
+        *chess_result = CHESS_OUT_OF_MEMORY;
+        return NULL;
+    }
+    journal->file = open(path_file, O_RDWR | O_CREAT | O_APPEND, FILE_MODE);
+    if (journal->file < 0 || !prepareFile(journal->file, sync_policy)) {
+        if (journal->file >= 0) {
+            close(journal->file);
+        }
+        free(journal);
+        *chess_result = CHESS_SAVE_FAILURE;
+        return NULL;
+    }
+    journal->buffer = NULL;
+    journal->size = 0;
+    journal->capacity = 0;
+    journal->records_num = 0;
+    journal->group_size = group_size < 1 ? 1 : group_size;
+    journal->sync_policy = sync_policy;
+    journal->is_synced = true;
+    journal->is_failed = false;
+    pthread_mutex_init(&journal->lock, NULL);
+    *chess_result = CHESS_SUCCESS;
+    return journal;
+}
+
+// writes the records of the group. the lock of the journal must be held.
+static ChessResult commit(Journal journal) {
+    if (journal->is_failed) {
+        return CHESS_SAVE_FAILURE;
+    }
+    if (journal->size > 0) {
+        journal->is_failed = !writeAll(journal->file, journal->buffer, journal->size);
+        journal->is_synced = false;
+        journal->size = 0;
+        journal->records_num = 0;
+    }
+    if (!journal->is_failed && !journal->is_synced && journal->sync_policy == CHESS_SYNC_ON_SAVE) {
+        journal->is_failed = fsync(journal->file) != 0;
+        journal->is_synced = true;
+    }
+    return journal->is_failed ? CHESS_SAVE_FAILURE : CHESS_SUCCESS;
+}
+
+ChessResult journalCommit(Journal journal) {
+    pthread_mutex_lock(&journal->lock);
+    ChessResult result = commit(journal);
+    pthread_mutex_unlock(&journal->lock);
+    return result;
+}
+
+ChessResult journalClose(Journal journal) {
+    if (journal == NULL) {
+        return CHESS_SUCCESS;
+    }
+    ChessResult result = journalCommit(journal);
+    if (close(journal->file) != 0) {
+        result = CHESS_SAVE_FAILURE;
+    }
+    pthread_mutex_destroy(&journal->lock);
+    free(journal->buffer);
+    free(journal);
+    return result;
+}
+
+void journalSetSyncPolicy(Journal journal, ChessSyncPolicy sync_policy) {
+    if (journal != NULL) {
+        journal->sync_policy = sync_policy;
+    }
+}
+
+static bool reserve(Journal journal, size_t size) {
+    if (journal->size + size <= journal->capacity) {
+        return true;
+    }
+    size_t capacity = journal->capacity == 0 ? INITIAL_BUFFER_SIZE : 2 * journal->capacity;
+    while (capacity < journal->size + size) {
+        capacity *= 2;
+    }
+    unsigned char* buffer = realloc(journal->buffer, capacity);
+    if (buffer == NULL) {
+        return false;
+    }
+    journal->buffer = buffer;
+    journal->capacity = capacity;
+    return true;
+}
+
+// adds a record to the group, and commits the group once it's full
+static void appendRecord(Journal journal, const int32_t* fields, int fields_num, const char* text, size_t text_size) {
+    if (journal == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&journal->lock);
+    size_t payload_size = fields_num * FIELD_SIZE + text_size;
+    if (journal->is_failed || !reserve(journal, FRAME_SIZE + payload_size)) {
+        journal->is_failed = true;
+        pthread_mutex_unlock(&journal->lock);
+        return;
+    }
+    unsigned char* payload = journal->buffer + journal->size + FRAME_SIZE;
+    memcpy(payload, fields, fields_num * FIELD_SIZE);
+    if (text_size > 0) {
+        memcpy(payload + fields_num * FIELD_SIZE, text, text_size);
+    }
+    Frame frame = { (uint32_t)payload_size, payloadChecksum(payload, payload_size) };
+    memcpy(journal->buffer + journal->size, &frame, FRAME_SIZE);
+    journal->size += FRAME_SIZE + payload_size;
+    if (++journal->records_num >= journal->group_size) {
+        commit(journal);
+    }
+    pthread_mutex_unlock(&journal->lock);
+}
+
+void journalAddTournament(Journal journal, int tournament_id, int max_games_per_player, const char* location) {
+    int32_t fields[] = { RECORD_ADD_TOURNAMENT, tournament_id, max_games_per_player };
+    appendRecord(journal, fields, sizeof(fields) / FIELD_SIZE, location, strlen(location));
+}
+
+void journalAddGame(Journal journal, int tournament_id, int first_player, int second_player,
+                    Winner winner, int play_time) {
+    int32_t fields[] = { RECORD_ADD_GAME, tournament_id, first_player, second_player, winner, play_time };
+    appendRecord(journal, fields, sizeof(fields) / FIELD_SIZE, NULL, 0);
+}
+
+void journalRemovePlayer(Journal journal, int player_id) {
+    int32_t fields[] = { RECORD_REMOVE_PLAYER, player_id };
+    appendRecord(journal, fields, sizeof(fields) / FIELD_SIZE, NULL, 0);
+}
+
+void journalRemoveTournament(Journal journal, int tournament_id) {
+    int32_t fields[] = { RECORD_REMOVE_TOURNAMENT, tournament_id };
+    appendRecord(journal, fields, sizeof(fields) / FIELD_SIZE, NULL, 0);
+}
+
+void journalEndTournament(Journal journal, int tournament_id) {
+    int32_t fields[] = { RECORD_END_TOURNAMENT, tournament_id };
+    appendRecord(journal, fields, sizeof(fields) / FIELD_SIZE, NULL, 0);
+}
+
+// the number of fields of a record of a given type, or 0 if there is no such type
+static int fieldsNum(int32_t type) {
+    switch (type) {
+        case RECORD_ADD_TOURNAMENT:
+            return 3;
+        case RECORD_ADD_GAME:
+            return 6;
+        case RECORD_REMOVE_PLAYER:
+        case RECORD_REMOVE_TOURNAMENT:
+        case RECORD_END_TOURNAMENT:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+static ChessResult replayAddTournament(ChessSystem chess, const int32_t* fields, const unsigned char* text,
+                                       size_t text_size) {
+    char* location = malloc(text_size + 1);
+    if (location == NULL) {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    memcpy(location, text, text_size);
+    location[text_size] = '\0';
+    ChessResult res = chessAddTournament(chess, fields[1], fields[2], location);
+    free(location);
+    return res;
+}
+
+// makes the call of a record again. returns false if the record isn't one a journal writes.
+static bool replayRecord(ChessSystem chess, const unsigned char* payload, size_t payload_size, ChessResult* res) {
+    int32_t fields[MAX_FIELDS];
+    if (payload_size < FIELD_SIZE) {
+        return false;
+    }
+    memcpy(fields, payload, FIELD_SIZE);
+    int fields_num = fieldsNum(fields[0]);
+    if (fields_num == 0 || payload_size < fields_num * FIELD_SIZE ||
+        (fields[0] != RECORD_ADD_TOURNAMENT && payload_size != fields_num * FIELD_SIZE)) {
+        return false;
+    }
+    memcpy(fields, payload, fields_num * FIELD_SIZE);
+    switch (fields[0]) {
+        case RECORD_ADD_TOURNAMENT:
+            *res = replayAddTournament(chess, fields, payload + fields_num * FIELD_SIZE,
+                                       payload_size - fields_num * FIELD_SIZE);
+            break;
+        case RECORD_ADD_GAME:
+            *res = chessAddGame(chess, fields[1], fields[2], fields[3], (Winner)fields[4], fields[5]);
+            break;
+        case RECORD_REMOVE_PLAYER:
+            *res = chessRemovePlayer(chess, fields[1]);
+            break;
+        case RECORD_REMOVE_TOURNAMENT:
+            *res = chessRemoveTournament(chess, fields[1]);
+            break;
+        default:
+            *res = chessEndTournament(chess, fields[1]);
+            break;
+    }
+    return true;
+}
+
+int journalReplay(ChessSystem chess, const void* data, size_t size, size_t* valid_size, ChessResult* chess_result) {
+    const unsigned char* bytes = data;
+    *valid_size = 0;
+    *chess_result = CHESS_SUCCESS;
+    // a header that was cut by a crash belongs to a journal with no records
+    if (size < sizeof(JournalHeader)) {
+        return 0;
+    }
+    if (!isValidHeader(data)) {
+        *chess_result = CHESS_SAVE_FAILURE;
+        return 0;
+    }
+    size_t offset = sizeof(JournalHeader);
+    int records_num = 0;
+    while (size - offset >= FRAME_SIZE) {
+        Frame frame;
+        memcpy(&frame, bytes + offset, FRAME_SIZE);
+        const unsigned char* payload = bytes + offset + FRAME_SIZE;
+        if (frame.payload_size > size - offset - FRAME_SIZE ||
+            payloadChecksum(payload, frame.payload_size) != frame.checksum) {
+            break;
+        }
+        // the logged calls changed the system when they were made, so they are expected to change it again
+        // and their results are only checked for running out of memory
+        ChessResult res;
+        if (!replayRecord(chess, payload, frame.payload_size, &res)) {
+            break;
+        }
+        if (res == CHESS_OUT_OF_MEMORY) {
+            *chess_result = CHESS_OUT_OF_MEMORY;
+            break;
+        }
+        offset += FRAME_SIZE + frame.payload_size;
+        records_num++;
+    }
+    *valid_size = offset;
+    return records_num;
+}
@@ -0,0 +1,116 @@
+#ifndef _JOURNAL_H
+#define _JOURNAL_H
+
+#include <stddef.h>
+
+/**
+ * Type for an append only log of the changes made to a chess system, which can be replayed to redo them.
+ * Records are gathered in memory and written to the file in groups, so a group shares one write, and one
+ * sync when the sync policy asks for it. Every record carries its own checksum, so a group that was only
+ * partly written before a crash is found and dropped when the log is replayed.
+ * Every function that logs a change does nothing when given a NULL journal.
+ */
+typedef struct journal_t *Journal;
+
+
+/**
+ * journalOpen: opens a journal file to append records to, and creates it if it doesn't exist.
+ *
+ * @param path_file - the path of the journal file.
+ * @param group_size - the number of records written together. Less than 1 is taken as 1.
+ * @param sync_policy - whether every group is synced to the disk once written.
+ * @param chess_result - pointer to write the result of the operation to.
+ *
+ * @return
+ * NULL if the operation failed, or the new journal otherwise.
+ * chess_result is set to:
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if the file couldn't be opened or written, or it isn't a complete journal.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+Journal journalOpen(const char* path_file, int group_size, ChessSyncPolicy sync_policy, ChessResult* chess_result);
+
+/**
+ * journalClose: commits the records of a journal that weren't written yet, and closes it.
+ *
+ * @param journal - the journal to close. May be NULL.
+ *
+ * @return
+ * CHESS_SAVE_FAILURE if a record of the journal failed to be written at any time.
+ * CHESS_SUCCESS otherwise.
+ *
+ */
+ChessResult journalClose(Journal journal);
+
+/**
+ * journalCommit: writes the group of records that is gathered in memory, even if it isn't full, and syncs it
+ *                if the sync policy asks for it.
+ *
+ * @param journal - the journal to commit.
+ *
+ * @return
+ * CHESS_SAVE_FAILURE if a record of the journal failed to be written at any time. Once that happened no more
+ *                    records are written, since a gap in the log would make replaying it wrong.
+ * CHESS_SUCCESS otherwise.
+ *
+ */
+ChessResult journalCommit(Journal journal);
+
+/**
+ * journalSetSyncPolicy: sets whether the following groups of a journal are synced to the disk once written.
+ *
+ * @param journal - the journal. May be NULL.
+ * @param sync_policy - the new sync policy.
+ *
+ */
+void journalSetSyncPolicy(Journal journal, ChessSyncPolicy sync_policy);
+
+/**
+ * journalAddTournament: logs a call of chessAddTournament that succeeded.
+ */
+void journalAddTournament(Journal journal, int tournament_id, int max_games_per_player, const char* location);
+
+/**
+ * journalAddGame: logs a call of chessAddGame that changed the system.
+ */
+void journalAddGame(Journal journal, int tournament_id, int first_player, int second_player,
+                    Winner winner, int play_time);
+
+/**
+ * journalRemovePlayer: logs a call of chessRemovePlayer that succeeded.
+ */
+void journalRemovePlayer(Journal journal, int player_id);
+
+/**
+ * journalRemoveTournament: logs a call of chessRemoveTournament that succeeded.
+ */
+void journalRemoveTournament(Journal journal, int tournament_id);
+
+/**
+ * journalEndTournament: logs a tournament that was ended by chessEndTournament or chessEndTournaments.
+ */
+void journalEndTournament(Journal journal, int tournament_id);
+
+/**
+ * journalReplay: makes again the calls logged in the contents of a journal file, in order, on a chess system.
+ *                Replaying stops at the first record that wasn't completely written.
+ *
+ * @param chess - the chess system to make the calls on. It must not log them to the same journal.
+ * @param data - the contents of the journal file.
+ * @param size - the size of the contents in bytes.
+ * @param valid_size - pointer to write the size of the part of the contents that holds complete records to.
+ *                     The file should be cut to it before records are appended to it again.
+ * @param chess_result - pointer to write the result of the operation to.
+ *
+ * @return
+ * the number of records that were replayed.
+ * chess_result is set to:
+ *     CHESS_SAVE_FAILURE - if the contents aren't a journal of this version. Nothing is replayed.
+ *     CHESS_OUT_OF_MEMORY - if a replayed call ran out of memory. The records after it aren't replayed.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ */
+int journalReplay(ChessSystem chess, const void* data, size_t size, size_t* valid_size, ChessResult* chess_result);
+
+#endif //_JOURNAL_H
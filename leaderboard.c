@@ -0,0 +1,603 @@
+#include "pool.h"
+#include "leaderboard.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#define PRIORITY_SEED 2463534242u
+// the room made for a line before it's formatted, which is enough for any line the chess system saves
+#define LINE_ROOM 64
+
+// the leaderboard is a treap: a search tree by (level, id) that is also a heap by a random priority,
+// which keeps it balanced. Each node knows the size of its subtree to answer rank queries.
+// The treap is persistent: a view shares the nodes of the leaderboard, and the leaderboard copies a shared node
+// before it changes it, with the path from the root to it, so the nodes a view sees never change.
+typedef struct node_t {
+    int player_id;
+    double level;
+    uint32_t priority;
+    int size;
+    // the number of pointers to the node, from its parent or the root and from the views that share it. it's only
+    // changed in place while it has one
+    int refs;
+    // the number of exports there were when the node was last inserted or moved, and the index of its key among
+    // the fresh keys of the export then
+    unsigned changed_in;
+    int change;
+    struct node_t* left;
+    struct node_t* right;
+} *Node;
+
+typedef struct {
+    int player_id;
+    bool is_removed;
+    double level;
+} Key;
+
+typedef struct {
+    int player_id;
+    int length; // of the line of the entry in the text of the export
+    double level;
+} Line;
+
+// the last export of the leaderboard, and what changed since. every entry that was moved or removed since leaves
+// the key its line was exported with among the stale keys, and every entry that was inserted or moved since has a
+// fresh key with its level now, so the next export merges the lines that didn't change with the fresh ones
+typedef struct {
+    bool is_kept; // false until the first export, and after a change couldn't be remembered
+    unsigned exports;
+    LeaderboardFormatter format;
+    Line* lines;
+    size_t lines_num;
+    size_t lines_capacity;
+    char* text;
+    size_t text_size;
+    size_t text_capacity;
+    Key* stale;
+    size_t stale_num;
+    size_t stale_capacity;
+    Key* fresh;
+    size_t fresh_num;
+    size_t fresh_capacity;
+    // the export is merged to these, and then they're swapped with the lines and the text
+    Line* next_lines;
+    size_t next_lines_num;
+    size_t next_lines_capacity;
+    char* next_text;
+    size_t next_text_size;
+    size_t next_text_capacity;
+} Export;
+
+struct leaderboard_t {
+    Node root;
+    Pool nodes;
+    uint32_t random_state;
+    // at most this many nodes are shared with views, and each of them is copied at most once, since its copy
+    // isn't shared. the pool always has room for them, so a copy never fails
+    int shared;
+    // the nodes the views let go of, linked through their left pointers. only the thread that changes the
+    // leaderboard uses the pool, so the views leave their nodes here, and it returns them to the pool
+    Node released;
+    // the leaderboard itself until it's destroyed, and its views. the last of them destroys the pool
+    int users;
+    Export export;
+};
+
+struct leaderboard_view_t {
+    Leaderboard leaderboard;
+    Node root;
+};
+
+// xorshift, so the shape of the tree depends only on the order of the operations
+static uint32_t nextPriority(Leaderboard leaderboard) {
+    uint32_t x = leaderboard->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    leaderboard->random_state = x;
+    return x;
+}
+
+static int nodeSize(Node node) {
+    return node == NULL ? 0 : node->size;
+}
+
+static void nodeUpdate(Node node) {
+    node->size = 1 + nodeSize(node->left) + nodeSize(node->right);
+}
+
+static void hold(Node node) {
+    if (node != NULL) {
+        __atomic_fetch_add(&node->refs, 1, __ATOMIC_RELAXED);
+    }
+}
+
+// lets go of a pointer to a node, and of the node's own pointers to its children once nothing points to it.
+// may be called from the thread of a view
+static void release(Leaderboard leaderboard, Node node) {
+    while (node != NULL && __atomic_sub_fetch(&node->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        release(leaderboard, node->right);
+        Node left = node->left;
+        node->left = __atomic_load_n(&leaderboard->released, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&leaderboard->released, &node->left, node, true, __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED)) {
+        }
+        node = left;
+    }
+}
+
+// returns the nodes the views let go of to the pool
+static void collectReleased(Leaderboard leaderboard) {
+    if (__atomic_load_n(&leaderboard->users, __ATOMIC_ACQUIRE) == 1) {
+        leaderboard->shared = 0;
+    }
+    if (__atomic_load_n(&leaderboard->released, __ATOMIC_RELAXED) == NULL) {
+        return;
+    }
+    Node node = __atomic_exchange_n(&leaderboard->released, NULL, __ATOMIC_ACQUIRE);
+    while (node != NULL) {
+        Node next = node->left;
+        poolFree(leaderboard->nodes, node);
+        node = next;
+    }
+}
+
+// gives a node that may be changed in place: the node itself if only its parent points to it, or else a copy
+// of it, which the caller puts in its place. the parent must not be shared either
+static Node own(Leaderboard leaderboard, Node node) {
+    if (__atomic_load_n(&node->refs, __ATOMIC_ACQUIRE) == 1) {
+        return node;
+    }
+    Node copy = poolAlloc(leaderboard->nodes);
+    assert(copy != NULL && leaderboard->shared > 0);
+    leaderboard->shared--;
+    copy->player_id = node->player_id;
+    copy->level = node->level;
+    copy->priority = node->priority;
+    copy->size = node->size;
+    copy->refs = 1;
+    copy->changed_in = node->changed_in;
+    copy->change = node->change;
+    copy->left = node->left;
+    copy->right = node->right;
+    hold(copy->left);
+    hold(copy->right);
+    release(leaderboard, node);
+    return copy;
+}
+
+// frees a leaderboard or a view of it, and the nodes and the leaderboard with the last of them
+static void leave(Leaderboard leaderboard) {
+    if (__atomic_sub_fetch(&leaderboard->users, 1, __ATOMIC_ACQ_REL) == 0) {
+        poolDestroy(leaderboard->nodes);
+        free(leaderboard);
+    }
+}
+
+// checks if the entry (level1, id1) is ranked before the entry (level2, id2)
+static bool isBefore(double level1, int id1, double level2, int id2) {
+    if (level1 != level2) {
+        return level1 > level2;
+    }
+    return id1 < id2;
+}
+
+// splits a tree to the entries ranked before the given entry, and the rest.
+// if include_key is true the given entry itself goes to the first part.
+static void split(Leaderboard leaderboard, Node node, double level, int player_id, bool include_key, Node* before,
+                  Node* after) {
+    if (node == NULL) {
+        *before = NULL;
+        *after = NULL;
+        return;
+    }
+    node = own(leaderboard, node);
+    bool goes_before = isBefore(node->level, node->player_id, level, player_id) ||
+                       (include_key && node->level == level && node->player_id == player_id);
+    if (goes_before) {
+        split(leaderboard, node->right, level, player_id, include_key, &node->right, after);
+        *before = node;
+    }
+    else {
+        split(leaderboard, node->left, level, player_id, include_key, before, &node->left);
+        *after = node;
+    }
+    nodeUpdate(node);
+}
+
+// merges two trees, when every entry of the first is ranked before every entry of the second
+static Node merge(Leaderboard leaderboard, Node first, Node second) {
+    if (first == NULL) {
+        return second;
+    }
+    if (second == NULL) {
+        return first;
+    }
+    if (first->priority > second->priority) {
+        first = own(leaderboard, first);
+        first->right = merge(leaderboard, first->right, second);
+        nodeUpdate(first);
+        return first;
+    }
+    second = own(leaderboard, second);
+    second->left = merge(leaderboard, first, second->left);
+    nodeUpdate(second);
+    return second;
+}
+
+static void attach(Leaderboard leaderboard, Node node) {
+    Node before, after;
+    split(leaderboard, leaderboard->root, node->level, node->player_id, false, &before, &after);
+    leaderboard->root = merge(leaderboard, merge(leaderboard, before, node), after);
+}
+
+static Node detach(Leaderboard leaderboard, int player_id, double level) {
+    Node before, key, after;
+    split(leaderboard, leaderboard->root, level, player_id, false, &before, &after);
+    split(leaderboard, after, level, player_id, true, &key, &after);
+    assert(key != NULL && key->size == 1);
+    leaderboard->root = merge(leaderboard, before, after);
+    return key;
+}
+
+// makes room for needed items in an array, which is left as it was if the allocation fails
+static void* reserve(void* items, size_t* capacity, size_t needed, size_t item_size) {
+    if (needed <= *capacity) {
+        return items;
+    }
+    size_t new_capacity = *capacity == 0 ? 16 : *capacity;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    items = realloc(items, new_capacity * item_size);
+    if (items != NULL) {
+        *capacity = new_capacity;
+    }
+    return items;
+}
+
+static bool pushKey(Key** keys, size_t* keys_num, size_t* capacity, int player_id, double level) {
+    Key* reserved = reserve(*keys, capacity, *keys_num + 1, sizeof(**keys));
+    if (reserved == NULL) {
+        return false;
+    }
+    *keys = reserved;
+    (*keys)[(*keys_num)++] = (Key){ player_id, false, level };
+    return true;
+}
+
+// stops remembering the changes when one of them can't be, so the next export starts from scratch
+static void forgetExport(Export* export) {
+    export->is_kept = false;
+    export->stale_num = 0;
+    export->fresh_num = 0;
+}
+
+static void rememberStale(Export* export, Node node) {
+    if (export->is_kept && node->changed_in != export->exports &&
+        !pushKey(&export->stale, &export->stale_num, &export->stale_capacity, node->player_id, node->level)) {
+        forgetExport(export);
+    }
+}
+
+// remembers an entry that was just inserted or moved, with its new level
+static void rememberFresh(Export* export, Node node) {
+    if (!export->is_kept) {
+        node->changed_in = export->exports;
+        return;
+    }
+    if (node->changed_in == export->exports) {
+        export->fresh[node->change].level = node->level;
+        return;
+    }
+    node->changed_in = export->exports;
+    node->change = export->fresh_num;
+    if (!pushKey(&export->fresh, &export->fresh_num, &export->fresh_capacity, node->player_id, node->level)) {
+        forgetExport(export);
+    }
+}
+
+static void rememberRemoved(Export* export, Node node) {
+    if (export->is_kept && node->changed_in == export->exports) {
+        export->fresh[node->change].is_removed = true;
+        return;
+    }
+    rememberStale(export, node);
+}
+
+Leaderboard leaderboardCreate() {
+    Leaderboard leaderboard = malloc(sizeof(*leaderboard));
+    if (leaderboard == NULL) {
+        return NULL;
+    }
+    leaderboard->nodes = poolCreate(sizeof(struct node_t));
+    if (leaderboard->nodes == NULL) {
+        free(leaderboard);
+        return NULL;
+    }
+    leaderboard->root = NULL;
+    leaderboard->random_state = PRIORITY_SEED;
+    leaderboard->shared = 0;
+    leaderboard->released = NULL;
+    leaderboard->users = 1;
+    memset(&leaderboard->export, 0, sizeof(leaderboard->export));
+    return leaderboard;
+}
+
+void leaderboardDestroy(Leaderboard leaderboard) {
+    if (leaderboard == NULL) {
+        return;
+    }
+    Export* export = &leaderboard->export;
+    free(export->lines);
+    free(export->text);
+    free(export->stale);
+    free(export->fresh);
+    free(export->next_lines);
+    free(export->next_text);
+    // every node is freed at once with the pool, once the views are destroyed too
+    leave(leaderboard);
+}
+
+int leaderboardGetSize(Leaderboard leaderboard) {
+    return nodeSize(leaderboard->root);
+}
+
+bool leaderboardInsert(Leaderboard leaderboard, int player_id, double level) {
+    collectReleased(leaderboard);
+    if (!poolReserve(leaderboard->nodes, leaderboard->shared + 1)) {
+        return false;
+    }
+    Node node = poolAlloc(leaderboard->nodes);
+    node->player_id = player_id;
+    node->level = level;
+    node->priority = nextPriority(leaderboard);
+    node->size = 1;
+    node->refs = 1;
+    node->changed_in = leaderboard->export.exports - 1;
+    node->left = NULL;
+    node->right = NULL;
+    rememberFresh(&leaderboard->export, node);
+    attach(leaderboard, node);
+    return true;
+}
+
+void leaderboardRemove(Leaderboard leaderboard, int player_id, double level) {
+    collectReleased(leaderboard);
+    Node node = detach(leaderboard, player_id, level);
+    rememberRemoved(&leaderboard->export, node);
+    poolFree(leaderboard->nodes, node);
+}
+
+void leaderboardMove(Leaderboard leaderboard, int player_id, double old_level, double new_level) {
+    collectReleased(leaderboard);
+    Node node = detach(leaderboard, player_id, old_level);
+    rememberStale(&leaderboard->export, node);
+    node->level = new_level;
+    rememberFresh(&leaderboard->export, node);
+    attach(leaderboard, node);
+}
+
+int leaderboardGetRank(Leaderboard leaderboard, int player_id, double level) {
+    int rank = 0;
+    Node node = leaderboard->root;
+    while (node != NULL) {
+        if (isBefore(level, player_id, node->level, node->player_id)) {
+            node = node->left;
+        }
+        else if (node->player_id == player_id) {
+            return rank + nodeSize(node->left);
+        }
+        else {
+            rank += nodeSize(node->left) + 1;
+            node = node->right;
+        }
+    }
+    assert(false);
+    return rank;
+}
+
+static bool walk(Node node, LeaderboardVisitor visit, void* context) {
+    if (node == NULL) {
+        return true;
+    }
+    return walk(node->left, visit, context) && visit(node->player_id, node->level, context) &&
+           walk(node->right, visit, context);
+}
+
+bool leaderboardWalk(Leaderboard leaderboard, LeaderboardVisitor visit, void* context) {
+    return walk(leaderboard->root, visit, context);
+}
+
+// makes room for size more characters of text in the export that is merged
+static bool reserveText(Export* export, size_t size) {
+    char* text = reserve(export->next_text, &export->next_text_capacity, export->next_text_size + size, 1);
+    if (text == NULL) {
+        return false;
+    }
+    export->next_text = text;
+    return true;
+}
+
+// formats the line of an entry at the end of the export that is merged
+static bool appendLine(Export* export, int player_id, double level) {
+    Line* lines = reserve(export->next_lines, &export->next_lines_capacity, export->next_lines_num + 1,
+                          sizeof(*lines));
+    if (lines == NULL) {
+        return false;
+    }
+    export->next_lines = lines;
+    size_t room = LINE_ROOM;
+    while (true) {
+        if (!reserveText(export, room)) {
+            return false;
+        }
+        int length = export->format(export->next_text + export->next_text_size, (int)room, player_id, level);
+        if (length < 0) {
+            return false;
+        }
+        if ((size_t)length < room) {
+            lines[export->next_lines_num++] = (Line){ player_id, length, level };
+            export->next_text_size += length;
+            return true;
+        }
+        room = (size_t)length + 1;
+    }
+}
+
+// copies the lines [first, last) of the last export, which start at the given offset of its text, to the end of
+// the export that is merged
+static bool appendLines(Export* export, size_t first, size_t last, size_t offset, size_t size) {
+    if (first == last) {
+        return true;
+    }
+    Line* lines = reserve(export->next_lines, &export->next_lines_capacity, export->next_lines_num + last - first,
+                          sizeof(*lines));
+    if (lines == NULL) {
+        return false;
+    }
+    export->next_lines = lines;
+    if (!reserveText(export, size)) {
+        return false;
+    }
+    memcpy(lines + export->next_lines_num, export->lines + first, (last - first) * sizeof(*lines));
+    export->next_lines_num += last - first;
+    memcpy(export->next_text + export->next_text_size, export->text + offset, size);
+    export->next_text_size += size;
+    return true;
+}
+
+static bool appendEntry(int player_id, double level, void* export) {
+    return appendLine(export, player_id, level);
+}
+
+static int compareKeys(const void* first, const void* second) {
+    const Key* key1 = first;
+    const Key* key2 = second;
+    if (isBefore(key1->level, key1->player_id, key2->level, key2->player_id)) {
+        return -1;
+    }
+    return isBefore(key2->level, key2->player_id, key1->level, key1->player_id);
+}
+
+static void sortKeys(Key* keys, size_t keys_num) {
+    if (keys_num > 1) {
+        qsort(keys, keys_num, sizeof(*keys), compareKeys);
+    }
+}
+
+// merges the lines of the last export whose entries didn't change with the fresh lines, in the order of the
+// leaderboard. the stale keys are the keys of some of the lines, in the same order, so both are walked at once
+static bool mergeExport(Export* export) {
+    size_t fresh_num = 0;
+    for (size_t i = 0; i < export->fresh_num; i++) {
+        if (!export->fresh[i].is_removed) {
+            export->fresh[fresh_num++] = export->fresh[i];
+        }
+    }
+    sortKeys(export->stale, export->stale_num);
+    sortKeys(export->fresh, fresh_num);
+    // the lines [run, line) are kept as they were, and start at run_offset of the text
+    size_t line = 0, run = 0, offset = 0, run_offset = 0, stale = 0, fresh = 0;
+    while (line < export->lines_num || fresh < fresh_num) {
+        Line* current = line < export->lines_num ? &export->lines[line] : NULL;
+        bool is_stale = current != NULL && stale < export->stale_num &&
+                        export->stale[stale].player_id == current->player_id &&
+                        export->stale[stale].level == current->level;
+        bool is_fresh_first = !is_stale && fresh < fresh_num &&
+                              (current == NULL || isBefore(export->fresh[fresh].level, export->fresh[fresh].player_id,
+                                                           current->level, current->player_id));
+        if (!is_stale && !is_fresh_first) {
+            offset += current->length;
+            line++;
+            continue;
+        }
+        if (!appendLines(export, run, line, run_offset, offset - run_offset)) {
+            return false;
+        }
+        if (is_stale) {
+            offset += current->length;
+            line++;
+            stale++;
+        }
+        else if (!appendLine(export, export->fresh[fresh].player_id, export->fresh[fresh].level)) {
+            return false;
+        }
+        else {
+            fresh++;
+        }
+        run = line;
+        run_offset = offset;
+    }
+    return appendLines(export, run, line, run_offset, offset - run_offset);
+}
+
+bool leaderboardExport(Leaderboard leaderboard, LeaderboardFormatter format, const char** text, size_t* size) {
+    Export* export = &leaderboard->export;
+    if (export->format != format) {
+        forgetExport(export);
+        export->format = format;
+    }
+    if (!export->is_kept || export->stale_num > 0 || export->fresh_num > 0) {
+        export->next_lines_num = 0;
+        export->next_text_size = 0;
+        bool is_merged = export->is_kept ? mergeExport(export) : walk(leaderboard->root, appendEntry, export);
+        forgetExport(export);
+        // the nodes that were changed since the last export are exported from now on
+        export->exports++;
+        if (!is_merged) {
+            return false;
+        }
+        Line* lines = export->lines;
+        export->lines = export->next_lines;
+        export->next_lines = lines;
+        size_t capacity = export->lines_capacity;
+        export->lines_capacity = export->next_lines_capacity;
+        export->next_lines_capacity = capacity;
+        export->lines_num = export->next_lines_num;
+        char* next_text = export->text;
+        export->text = export->next_text;
+        export->next_text = next_text;
+        capacity = export->text_capacity;
+        export->text_capacity = export->next_text_capacity;
+        export->next_text_capacity = capacity;
+        export->text_size = export->next_text_size;
+        export->is_kept = true;
+    }
+    *text = export->text;
+    *size = export->text_size;
+    return true;
+}
+
+LeaderboardView leaderboardViewCreate(Leaderboard leaderboard) {
+    collectReleased(leaderboard);
+    // every node of the leaderboard is shared from now on
+    int size = nodeSize(leaderboard->root);
+    LeaderboardView view = malloc(sizeof(*view));
+    if (view == NULL || !poolReserve(leaderboard->nodes, size)) {
+        free(view);
+        return NULL;
+    }
+    leaderboard->shared = size;
+    __atomic_fetch_add(&leaderboard->users, 1, __ATOMIC_RELAXED);
+    view->leaderboard = leaderboard;
+    view->root = leaderboard->root;
+    hold(view->root);
+    return view;
+}
+
+void leaderboardViewDestroy(LeaderboardView view) {
+    if (view == NULL) {
+        return;
+    }
+    release(view->leaderboard, view->root);
+    leave(view->leaderboard);
+    free(view);
+}
+
+bool leaderboardViewWalk(LeaderboardView view, LeaderboardVisitor visit, void* context) {
+    return walk(view->root, visit, context);
+}
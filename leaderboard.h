@@ -0,0 +1,177 @@
+#ifndef _LEADERBOARD_H
+#define _LEADERBOARD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Type for the ranking of players by level. Entries are kept ordered by level from highest to lowest,
+ * and players with the same level by id from lowest to highest, so the order is the one the levels
+ * are saved in. Every operation but the walk and the export takes O(log n) expected time.
+ */
+typedef struct leaderboard_t *Leaderboard;
+
+/**
+ * Type for a frozen copy of a leaderboard, which shares the entries of the leaderboard instead of copying them.
+ * The leaderboard copies an entry it shares before it changes it, with the entries on the way to it from the
+ * root, so taking a view takes O(1) time and every change of the leaderboard copies O(log n) entries at most once.
+ * A view may be walked and destroyed by any thread while another thread changes the leaderboard, and it may
+ * outlive the leaderboard.
+ */
+typedef struct leaderboard_view_t *LeaderboardView;
+
+/**
+ * Type of the function called for each entry of a walk over the leaderboard.
+ * Returns true to go on to the next entry, or false to stop the walk.
+ */
+typedef bool (*LeaderboardVisitor)(int player_id, double level, void* context);
+
+/**
+ * Type of the function that writes the line of an entry for leaderboardExport. Like snprintf, it writes at most
+ * size characters to line, including the terminating null character, and returns the length of the whole line,
+ * or a negative number if it failed.
+ */
+typedef int (*LeaderboardFormatter)(char* line, int size, int player_id, double level);
+
+
+/**
+ * leaderboardCreate: allocates a new empty leaderboard.
+ *
+ * @return NULL if the allocation failed, or the new leaderboard otherwise.
+ *
+ */
+Leaderboard leaderboardCreate();
+
+/**
+ * leaderboardDestroy: frees a leaderboard and all its entries, or leaves the entries to its views until the
+ *                     last of them is destroyed.
+ *
+ * @param leaderboard - the leaderboard to destroy. May be NULL.
+ *
+ */
+void leaderboardDestroy(Leaderboard leaderboard);
+
+/**
+ * leaderboardGetSize: gives the number of players in the leaderboard.
+ *
+ * @param leaderboard - the leaderboard that is checked.
+ *
+ * @return the number of players in the leaderboard.
+ *
+ */
+int leaderboardGetSize(Leaderboard leaderboard);
+
+/**
+ * leaderboardInsert: adds a player that is not in the leaderboard yet.
+ *
+ * @param leaderboard - the leaderboard the player is added to.
+ * @param player_id - the id of the player.
+ * @param level - the level of the player.
+ *
+ * @return false if the allocation failed, or true otherwise.
+ *
+ */
+bool leaderboardInsert(Leaderboard leaderboard, int player_id, double level);
+
+/**
+ * leaderboardRemove: removes a player from the leaderboard.
+ *
+ * @param leaderboard - the leaderboard the player is removed from.
+ * @param player_id - the id of the player. Must be in the leaderboard.
+ * @param level - the level the player was inserted or last moved with.
+ *
+ */
+void leaderboardRemove(Leaderboard leaderboard, int player_id, double level);
+
+/**
+ * leaderboardMove: changes the level of a player in the leaderboard. Unlike a removal followed by an insertion
+ *                  it allocates nothing, so it can't fail. The copies of entries it shares with views are made
+ *                  in the room leaderboardViewCreate made for them.
+ *
+ * @param leaderboard - the leaderboard the player is in.
+ * @param player_id - the id of the player. Must be in the leaderboard.
+ * @param old_level - the level the player was inserted or last moved with.
+ * @param new_level - the new level of the player.
+ *
+ */
+void leaderboardMove(Leaderboard leaderboard, int player_id, double old_level, double new_level);
+
+/**
+ * leaderboardGetRank: gives the position of a player in the leaderboard.
+ *
+ * @param leaderboard - the leaderboard the player is in.
+ * @param player_id - the id of the player. Must be in the leaderboard.
+ * @param level - the level the player was inserted or last moved with.
+ *
+ * @return the number of players that are ranked before the player, so the first player is at 0.
+ *
+ */
+int leaderboardGetRank(Leaderboard leaderboard, int player_id, double level);
+
+/**
+ * leaderboardWalk: calls a given function for the players of the leaderboard in their order, from the first one,
+ *                  until the function returns false. Walking over the first k players takes O(log n + k) time.
+ *                  The leaderboard must not be changed during the walk.
+ *
+ * @param leaderboard - the leaderboard to walk over.
+ * @param visit - the function called for every player.
+ * @param context - passed as is to every call of visit.
+ *
+ * @return false if a call of visit returned false, or true otherwise.
+ *
+ */
+bool leaderboardWalk(Leaderboard leaderboard, LeaderboardVisitor visit, void* context);
+
+/**
+ * leaderboardExport: gives the lines of the players of the leaderboard in their order, as one text.
+ *                    The leaderboard keeps the text of the last export, and the entries that were inserted, moved
+ *                    or removed since, so only the lines of those entries are formatted again, and the others are
+ *                    copied from the last export in runs. An export after k changes takes O(k log k) time and
+ *                    O(n) copying, and one after no changes gives the text as it was.
+ *
+ * @param leaderboard - the leaderboard to export.
+ * @param format - the function that writes the line of an entry. The text is made from scratch when it's not
+ *                 the one the last export was made with.
+ * @param text - pointer to write the text to. It's valid until the next export or until the leaderboard is
+ *               destroyed, and it isn't null terminated.
+ * @param size - pointer to write the length of the text to.
+ *
+ * @return false if an allocation or a call of format failed, or true otherwise. The next export after a failure
+ *         makes the text from scratch.
+ *
+ */
+bool leaderboardExport(Leaderboard leaderboard, LeaderboardFormatter format, const char** text, size_t* size);
+
+/**
+ * leaderboardViewCreate: takes a view of the leaderboard as it is now. Makes room for a copy of every entry
+ *                        it shares, so the changes of the leaderboard that can't fail still can't.
+ *
+ * @param leaderboard - the leaderboard to view.
+ *
+ * @return NULL if an allocation failed, or the new view otherwise.
+ *
+ */
+LeaderboardView leaderboardViewCreate(Leaderboard leaderboard);
+
+/**
+ * leaderboardViewDestroy: frees a view of a leaderboard.
+ *
+ * @param view - the view to destroy. May be NULL.
+ *
+ */
+void leaderboardViewDestroy(LeaderboardView view);
+
+/**
+ * leaderboardViewWalk: walks over the players of a view like leaderboardWalk, in the order of the leaderboard
+ *                      when the view was taken.
+ *
+ * @param view - the view to walk over.
+ * @param visit - the function called for every player.
+ * @param context - passed as is to every call of visit.
+ *
+ * @return false if a call of visit returned false, or true otherwise.
+ *
+ */
+bool leaderboardViewWalk(LeaderboardView view, LeaderboardVisitor visit, void* context);
+
+#endif //_LEADERBOARD_H
@@ -0,0 +1,158 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "locks.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#define TOURNAMENT_SHARDS 64
+#define PLAYER_STRIPES 256
+#define CACHE_LINE_SIZE 64
+#define INITIAL_DEFERRED_CAPACITY 16
+
+// every lock takes a cache line of its own, so threads that hold neighbouring locks don't slow each other down
+typedef union {
+    pthread_mutex_t mutex;
+    char padding[CACHE_LINE_SIZE];
+} Shard;
+
+typedef union {
+    struct {
+        pthread_mutex_t mutex;
+        // the players of the stripe whose moves in the leaderboard were deferred
+        int* deferred;
+        int deferred_num;
+        int deferred_capacity;
+    } lock;
+    char padding[CACHE_LINE_SIZE];
+} Stripe;
+
+struct locks_t {
+    Shard shards[TOURNAMENT_SHARDS];
+    Stripe stripes[PLAYER_STRIPES];
+    pthread_rwlock_t system;
+    pthread_mutex_t leaderboard;
+};
+
+static Shard* shardOf(Locks locks, int tournament_id) {
+    return &locks->shards[(unsigned)tournament_id % TOURNAMENT_SHARDS];
+}
+
+static int stripeIndex(int player_id) {
+    return (unsigned)player_id % PLAYER_STRIPES;
+}
+
+Locks locksCreate() {
+    void* memory;
+    if (posix_memalign(&memory, CACHE_LINE_SIZE, sizeof(struct locks_t)) != 0) {
+        return NULL;
+    }
+    Locks locks = memory;
+    if (pthread_rwlock_init(&locks->system, NULL) != 0) {
+        free(locks);
+        return NULL;
+    }
+    pthread_mutex_init(&locks->leaderboard, NULL);
+    for (int i = 0; i < TOURNAMENT_SHARDS; i++) {
+        pthread_mutex_init(&locks->shards[i].mutex, NULL);
+    }
+    for (int i = 0; i < PLAYER_STRIPES; i++) {
+        pthread_mutex_init(&locks->stripes[i].lock.mutex, NULL);
+        locks->stripes[i].lock.deferred = NULL;
+        locks->stripes[i].lock.deferred_num = 0;
+        locks->stripes[i].lock.deferred_capacity = 0;
+    }
+    return locks;
+}
+
+void locksDestroy(Locks locks) {
+    if (locks == NULL) {
+        return;
+    }
+    for (int i = 0; i < PLAYER_STRIPES; i++) {
+        pthread_mutex_destroy(&locks->stripes[i].lock.mutex);
+        free(locks->stripes[i].lock.deferred);
+    }
+    for (int i = 0; i < TOURNAMENT_SHARDS; i++) {
+        pthread_mutex_destroy(&locks->shards[i].mutex);
+    }
+    pthread_mutex_destroy(&locks->leaderboard);
+    pthread_rwlock_destroy(&locks->system);
+    free(locks);
+}
+
+void locksLockShared(Locks locks) {
+    pthread_rwlock_rdlock(&locks->system);
+}
+
+void locksLockExclusive(Locks locks) {
+    pthread_rwlock_wrlock(&locks->system);
+}
+
+void locksUnlock(Locks locks) {
+    pthread_rwlock_unlock(&locks->system);
+}
+
+void locksLockTournament(Locks locks, int tournament_id) {
+    pthread_mutex_lock(&shardOf(locks, tournament_id)->mutex);
+}
+
+void locksUnlockTournament(Locks locks, int tournament_id) {
+    pthread_mutex_unlock(&shardOf(locks, tournament_id)->mutex);
+}
+
+void locksLockPlayers(Locks locks, int first_player, int second_player) {
+    int first = stripeIndex(first_player), second = stripeIndex(second_player);
+    if (first > second) {
+        int lower = second;
+        second = first;
+        first = lower;
+    }
+    pthread_mutex_lock(&locks->stripes[first].lock.mutex);
+    if (second != first) {
+        pthread_mutex_lock(&locks->stripes[second].lock.mutex);
+    }
+}
+
+void locksUnlockPlayers(Locks locks, int first_player, int second_player) {
+    int first = stripeIndex(first_player), second = stripeIndex(second_player);
+    if (second != first) {
+        pthread_mutex_unlock(&locks->stripes[second].lock.mutex);
+    }
+    pthread_mutex_unlock(&locks->stripes[first].lock.mutex);
+}
+
+void locksLockLeaderboard(Locks locks) {
+    pthread_mutex_lock(&locks->leaderboard);
+}
+
+void locksUnlockLeaderboard(Locks locks) {
+    pthread_mutex_unlock(&locks->leaderboard);
+}
+
+bool locksDeferPlayer(Locks locks, int player_id) {
+    Stripe* stripe = &locks->stripes[stripeIndex(player_id)];
+    if (stripe->lock.deferred_num == stripe->lock.deferred_capacity) {
+        int capacity = stripe->lock.deferred_capacity == 0 ? INITIAL_DEFERRED_CAPACITY
+                                                            : 2 * stripe->lock.deferred_capacity;
+        int* deferred = realloc(stripe->lock.deferred, sizeof(*deferred) * capacity);
+        if (deferred == NULL) {
+            return false;
+        }
+        stripe->lock.deferred = deferred;
+        stripe->lock.deferred_capacity = capacity;
+    }
+    stripe->lock.deferred[stripe->lock.deferred_num++] = player_id;
+    return true;
+}
+
+void locksFinishDeferredPlayers(Locks locks, DeferredPlayerVisitor visit, void* context) {
+    for (int i = 0; i < PLAYER_STRIPES; i++) {
+        Stripe* stripe = &locks->stripes[i];
+        for (int j = 0; j < stripe->lock.deferred_num; j++) {
+            visit(stripe->lock.deferred[j], context);
+        }
+        stripe->lock.deferred_num = 0;
+    }
+}
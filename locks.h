@@ -0,0 +1,102 @@
+#ifndef _LOCKS_H
+#define _LOCKS_H
+
+#include <stdbool.h>
+
+/**
+ * Type for the locks of a chess system that is used by several threads at once.
+ * The system lock is held shared by calls that only change one tournament and its players, and exclusively
+ * by every other call. A shared holder also locks the shard of its tournament and the stripes of its players,
+ * and the leaderboard when it changes its structure. Locks are always taken in that order, and the stripes of
+ * two players from the lowest, so holders never wait for each other in a cycle.
+ * A stripe also keeps the players of its lock whose moves in the leaderboard were deferred by shared holders,
+ * so the next exclusive holder finishes only those moves.
+ */
+typedef struct locks_t* Locks;
+
+/** Type of a function that is called for every player whose move in the leaderboard was deferred */
+typedef void (*DeferredPlayerVisitor)(int player_id, void* context);
+
+
+/**
+ * locksCreate: allocates the locks of a chess system.
+ *
+ * @return
+ * NULL if an allocation failed, or the new locks otherwise.
+ */
+Locks locksCreate();
+
+/**
+ * locksDestroy: deallocates locks that no thread holds. Does nothing if locks is NULL.
+ */
+void locksDestroy(Locks locks);
+
+/**
+ * locksLockShared: locks the system for a call that only changes one tournament and its players, together with
+ *                  other such calls. The tournaments and the players can't be added or removed meanwhile.
+ */
+void locksLockShared(Locks locks);
+
+/**
+ * locksLockExclusive: locks the system for a call that no other call may run with.
+ */
+void locksLockExclusive(Locks locks);
+
+/**
+ * locksUnlock: unlocks the system, after locksLockShared or locksLockExclusive.
+ */
+void locksUnlock(Locks locks);
+
+/**
+ * locksLockTournament: locks the shard of a tournament, which is shared with the tournaments whose ids
+ *                      fall in the same shard. The system must be locked shared.
+ */
+void locksLockTournament(Locks locks, int tournament_id);
+
+/**
+ * locksUnlockTournament: unlocks the shard of a tournament.
+ */
+void locksUnlockTournament(Locks locks, int tournament_id);
+
+/**
+ * locksLockPlayers: locks the stripes of two players, or the single stripe they share.
+ *                   The same id may be given twice to lock one player. The system must be locked shared.
+ */
+void locksLockPlayers(Locks locks, int first_player, int second_player);
+
+/**
+ * locksUnlockPlayers: unlocks the stripes of two players locked by locksLockPlayers.
+ */
+void locksUnlockPlayers(Locks locks, int first_player, int second_player);
+
+/**
+ * locksLockLeaderboard: locks the leaderboard, after the tournament and the players.
+ */
+void locksLockLeaderboard(Locks locks);
+
+/**
+ * locksUnlockLeaderboard: unlocks the leaderboard.
+ */
+void locksUnlockLeaderboard(Locks locks);
+
+/**
+ * locksDeferPlayer: remembers a player whose move in the leaderboard was deferred. The stripe of the player
+ *                   must be locked, and the player must not be remembered already.
+ *
+ * @return
+ * false if an allocation failed, and the player isn't remembered. true otherwise.
+ */
+bool locksDeferPlayer(Locks locks, int player_id);
+
+/**
+ * locksFinishDeferredPlayers: calls a function for every player remembered by locksDeferPlayer, and forgets
+ *                             them. The system must be locked exclusively.
+ *
+ * @param locks - the locks.
+ * @param visit - the function to call, with the id of the player.
+ * @param context - passed as is to every call of visit.
+ *
+ */
+void locksFinishDeferredPlayers(Locks locks, DeferredPlayerVisitor visit, void* context);
+
+#endif //_LOCKS_H
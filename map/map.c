@@ -1,25 +1,41 @@
 /* map data structure */
 
 #include "map.h"
+#include "mapExtensions.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <assert.h>
 
 #define INITIAL_SIZE 10
 #define EXPAND_FACTOR 2
 #define ELEMENT_NOT_FOUND -1
+#define SLOTS_LOAD_FACTOR 2
+#define HASH_MULTIPLIER 2654435769u
+#define HASH_BITS 32
 
 typedef struct {
     MapDataElement data;
     MapKeyElement key;
 } Element;
 
+// an entry of the hash table of int keyed maps. slots that hold no element have NULL data.
+typedef struct {
+    int id;
+    MapDataElement data;
+} Slot;
+
 struct Map_t {
     int size;
     int max_size;
     int iterator;
-    Element* elements;
+    Element* elements; // generic maps: key and data pairs sorted by key
+    int* ids; // int keyed maps: the keys, sorted, to keep the iteration order
+    Slot* slots; // int keyed maps: open addressing table from a key to its data
+    uint32_t slots_mask;
+    int slots_shift;
     copyMapDataElements copyDataElement;
     copyMapKeyElements copyKeyElement;
     freeMapDataElements freeDataElement;
@@ -27,6 +43,154 @@ struct Map_t {
     compareMapKeyElements compareKeyElements;
 };
 
+#ifdef CHESS_METRICS
+static MapMetrics metrics;
+// the counters may be updated by several threads at once, which don't need to agree on their order
+#define COUNT(counter) __atomic_fetch_add(&metrics.counter, 1, __ATOMIC_RELAXED)
+#else
+#define COUNT(counter) ((void)0)
+#endif
+
+static MapKeyElement intKeyCopy(MapKeyElement key) {
+    COUNT(allocations);
+    int* copy = malloc(sizeof(*copy));
+    if(copy == NULL)
+        return NULL;
+    *copy = *(int*)key;
+    return copy;
+}
+
+static void intKeyFree(MapKeyElement key) {
+    free(key);
+}
+
+static int intKeyCompare(MapKeyElement key1, MapKeyElement key2) {
+    int const id1 = *(int*)key1, id2 = *(int*)key2;
+    return (id1 > id2) - (id1 < id2);
+}
+
+static bool isIntKeyed(Map map) {
+    return map->ids != NULL;
+}
+
+static uint32_t hashSlot(Map map, int id) {
+    return ((uint32_t)id * HASH_MULTIPLIER) >> map->slots_shift;
+}
+
+// the slot that holds id, or the empty slot that ends its probe sequence
+static uint32_t probe(Map map, int id) {
+    uint32_t slot = hashSlot(map, id);
+    COUNT(comparisons);
+    while(map->slots[slot].data != NULL && map->slots[slot].id != id) {
+        slot = (slot + 1) & map->slots_mask;
+        COUNT(comparisons);
+    }
+    return slot;
+}
+
+// (re)builds the hash table with room for max_size elements at the wanted load factor
+static MapResult buildSlots(Map map) {
+    int bits = 1;
+    while((1 << bits) < SLOTS_LOAD_FACTOR*map->max_size)
+        bits++;
+    Slot* old_slots = map->slots;
+    uint32_t const old_mask = map->slots_mask;
+    COUNT(allocations);
+    map->slots = calloc(1u << bits, sizeof(Slot));
+    if(map->slots == NULL) {
+        map->slots = old_slots;
+        return MAP_OUT_OF_MEMORY;
+    }
+    map->slots_mask = (1u << bits) - 1;
+    map->slots_shift = HASH_BITS - bits;
+    if(old_slots != NULL) {
+        for(uint32_t i = 0; i <= old_mask; i++) {
+            if(old_slots[i].data != NULL)
+                map->slots[probe(map, old_slots[i].id)] = old_slots[i];
+        }
+    }
+    free(old_slots);
+    return MAP_SUCCESS;
+}
+
+// empties a slot and shifts the rest of its cluster back, so no tombstones are needed
+static void deleteSlot(Map map, uint32_t hole) {
+    uint32_t slot = hole;
+    while(true) {
+        slot = (slot + 1) & map->slots_mask;
+        if(map->slots[slot].data == NULL)
+            break;
+        uint32_t home = hashSlot(map, map->slots[slot].id);
+        // the entry may fill the hole only if the hole lies on its probe path
+        if(((slot - home) & map->slots_mask) >= ((slot - hole) & map->slots_mask)) {
+            map->slots[hole] = map->slots[slot];
+            hole = slot;
+        }
+    }
+    map->slots[hole].data = NULL;
+}
+
+// the position of id in the sorted ids array, or where it belongs if it is not there.
+// ids mostly arrive in increasing order, so the end is checked first.
+static int findId(Map map, int id) {
+    if(map->size == 0 || map->ids[map->size-1] < id)
+        return map->size;
+    int low = 0;
+    int high = map->size - 1;
+    while(low < high) {
+        int middle = low + (high - low) / 2;
+        COUNT(comparisons);
+        if(map->ids[middle] < id)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+static Map mapAllocate(copyMapDataElements copyDataElement,
+                       copyMapKeyElements copyKeyElement,
+                       freeMapDataElements freeDataElement,
+                       freeMapKeyElements freeKeyElement,
+                       compareMapKeyElements compareKeyElements,
+                       bool int_keys, int max_size) {
+    COUNT(allocations);
+    Map map = malloc(sizeof(*map));
+    if(map == NULL){
+        printf("Dynamic Allocation Error");
+        return NULL;
+    }
+    map->size = 0;
+    map->max_size = max_size;
+    map->iterator = 0;
+    map->elements = NULL;
+    map->ids = NULL;
+    map->slots = NULL;
+    bool allocated;
+    COUNT(allocations);
+    if(int_keys) {
+        map->ids = malloc(sizeof(*map->ids)*max_size);
+        allocated = (map->ids != NULL && buildSlots(map) == MAP_SUCCESS);
+    }
+    else {
+        map->elements = malloc(sizeof(Element)*max_size);
+        allocated = (map->elements != NULL);
+    }
+    if(!allocated)
+    {
+        free(map->ids);
+        free(map->elements);
+        free(map);
+        return NULL;
+    }
+    map->copyDataElement = copyDataElement;
+    map->copyKeyElement = copyKeyElement;
+    map->freeDataElement = freeDataElement;
+    map->freeKeyElement = freeKeyElement;
+    map->compareKeyElements = compareKeyElements;
+    return map;
+}
+
 Map mapCreate(copyMapDataElements copyDataElement,
               copyMapKeyElements copyKeyElement,
               freeMapDataElements freeDataElement,
@@ -36,58 +200,85 @@ Map mapCreate(copyMapDataElements copyDataElement,
                     freeKeyElement == NULL || compareKeyElements == NULL)
                         return NULL;
 
-                   Map map = malloc(sizeof(*map));
-                    if(map == NULL){
-                        printf("Dynamic Allocation Error");
-                        return NULL;
-                    }
-                        
-                    map->size = 0;
-                    map->max_size=INITIAL_SIZE;
-                    map->elements = malloc(sizeof(Element)*INITIAL_SIZE);
-                    if(map->elements == NULL)
-                    {
-                        free(map);
-                        return NULL;
-                    }
-                    map->copyDataElement = copyDataElement;
-                    map->copyKeyElement = copyKeyElement;
-                    map->freeDataElement = freeDataElement;
-                    map->freeKeyElement = freeKeyElement;
-                    map->compareKeyElements = compareKeyElements;
-
-                    return map;
+                  return mapAllocate(copyDataElement, copyKeyElement, freeDataElement, freeKeyElement,
+                                     compareKeyElements, false, INITIAL_SIZE);
               }
 
+Map mapCreateIntKeyed(copyMapDataElements copyDataElement, freeMapDataElements freeDataElement) {
+    if(copyDataElement == NULL || freeDataElement == NULL)
+        return NULL;
+    return mapAllocate(copyDataElement, intKeyCopy, freeDataElement, intKeyFree, intKeyCompare,
+                       true, INITIAL_SIZE);
+}
+
 void mapDestroy(Map map) {
     if(map == NULL)
         return;
     mapClear(map);
+    free(map->slots);
+    free(map->ids);
     free(map->elements);
     free(map);
 }
 
+// copies the elements of an int keyed map into an empty one allocated with the same max_size
+static MapResult copyIntKeyed(Map map, Map new_map) {
+    memcpy(new_map->slots, map->slots, sizeof(Slot)*(map->slots_mask + 1));
+    for (uint32_t i = 0; i <= map->slots_mask; i++) {
+        if (map->slots[i].data == NULL)
+            continue;
+        COUNT(copies);
+        new_map->slots[i].data = map->copyDataElement(map->slots[i].data);
+        if (new_map->slots[i].data == NULL) {
+            // drop the entries that still point to the data of the original map
+            for (uint32_t j = i + 1; j <= map->slots_mask; j++)
+                new_map->slots[j].data = NULL;
+            for (uint32_t j = 0; j < i; j++) {
+                if (new_map->slots[j].data != NULL)
+                    new_map->freeDataElement(new_map->slots[j].data);
+            }
+            return MAP_OUT_OF_MEMORY;
+        }
+    }
+    memcpy(new_map->ids, map->ids, sizeof(*map->ids)*map->size);
+    new_map->size = map->size;
+    return MAP_SUCCESS;
+}
+
 Map mapCopy (Map map) {
     if (map == NULL)
         return NULL;
-    Map new_map = mapCreate(map->copyDataElement, map->copyKeyElement, map->freeDataElement,
-                            map->freeKeyElement, map->compareKeyElements);
+    Map new_map = mapAllocate(map->copyDataElement, map->copyKeyElement, map->freeDataElement,
+                              map->freeKeyElement, map->compareKeyElements, isIntKeyed(map), map->max_size);
     if (new_map == NULL) {
         printf("Dynamic Allocation Error");
         return NULL;
     }
+    if (isIntKeyed(map)) {
+        if (copyIntKeyed(map, new_map) != MAP_SUCCESS) {
+            free(new_map->slots);
+            free(new_map->ids);
+            free(new_map);
+            return NULL;
+        }
+        return new_map;
+    }
     for (int i = 0; i < map->size; i++) {
-        new_map->elements[i].data = map->copyDataElement(map->elements[i].data);
-        new_map->elements[i].key = map->copyKeyElement(map->elements[i].key);
+        Element* new_element = &new_map->elements[i];
+        COUNT(copies);
+        new_element->data = map->copyDataElement(map->elements[i].data);
+        COUNT(copies);
+        new_element->key = map->copyKeyElement(map->elements[i].key);
+        if (new_element->data == NULL || new_element->key == NULL) {
+            if (new_element->data != NULL)
+                map->freeDataElement(new_element->data);
+            if (new_element->key != NULL)
+                map->freeKeyElement(new_element->key);
+            mapDestroy(new_map);
+            return NULL;
+        }
+        new_map->size++;
     }
-    new_map->size = map->size;
-    new_map->max_size = map->max_size;
-    new_map->copyDataElement = map->copyDataElement;
-    new_map->copyKeyElement = map->copyKeyElement;
-    new_map->freeDataElement = map->freeDataElement;
-    new_map->freeKeyElement = map->freeKeyElement;
-    new_map->compareKeyElements = map->compareKeyElements;
-
     return new_map;
 }
 
@@ -98,25 +289,58 @@ int mapGetSize(Map map) {
     return map->size;
 }
 
-bool mapContains(Map map, MapKeyElement element) {
-    for(int i = 0; i < map->size; i++) {
-         if(map->compareKeyElements(map->elements[i].key, element) == 0)
-            return true;
+// binary search over the sorted elements array of a generic map. returns the index of the key, or
+// ELEMENT_NOT_FOUND if it is not in the map. if insert_index is not NULL it is set to the index the
+// key belongs in.
+static int find(Map map, MapKeyElement keyElement, int* insert_index) {
+    int low = 0;
+    int high = map->size - 1;
+    while(low <= high) {
+        int middle = low + (high - low) / 2;
+        COUNT(comparisons);
+        int compare_result = map->compareKeyElements(map->elements[middle].key, keyElement);
+        if(compare_result == 0) {
+            if(insert_index != NULL)
+                *insert_index = middle;
+            return middle;
+        }
+        if(compare_result < 0)
+            low = middle + 1;
+        else
+            high = middle - 1;
     }
-    return false;
+    if(insert_index != NULL)
+        *insert_index = low;
+    return ELEMENT_NOT_FOUND;
 }
 
-static int find(Map map, MapKeyElement keyElement) {
-    for(int i = 0; i < map->size; i++) {
-        if(map->compareKeyElements(map->elements[i].key, keyElement) == 0)
-            return i;
-    }
-    return -1;
+bool mapContains(Map map, MapKeyElement element) {
+    if(map == NULL || element == NULL)
+        return false;
+    if(isIntKeyed(map))
+        return map->slots[probe(map, *(int*)element)].data != NULL;
+    return find(map, element, NULL) != ELEMENT_NOT_FOUND;
 }
 
-static MapResult expand(Map map) {
-    int new_size = EXPAND_FACTOR*(map->size);
-    Element* new_elements = realloc(map->elements, new_size*sizeof(*map));
+// gives the map room for new_size elements, keeping the ones it holds
+static MapResult resize(Map map, int new_size) {
+    COUNT(expansions);
+    COUNT(allocations);
+    if(isIntKeyed(map)) {
+        int* new_ids = realloc(map->ids, new_size*sizeof(*new_ids));
+        if(new_ids == NULL) {
+            return MAP_OUT_OF_MEMORY;
+        }
+        map->ids = new_ids;
+        int const old_size = map->max_size;
+        map->max_size = new_size;
+        if(buildSlots(map) != MAP_SUCCESS) {
+            map->max_size = old_size;
+            return MAP_OUT_OF_MEMORY;
+        }
+        return MAP_SUCCESS;
+    }
+    Element* new_elements = realloc(map->elements, new_size*sizeof(Element));
     if(new_elements == NULL) {
         return MAP_OUT_OF_MEMORY;
     }
@@ -125,100 +349,164 @@ static MapResult expand(Map map) {
     return MAP_SUCCESS;
 }
 
-static int findCorrectIndex(Map map, MapKeyElement keyElement) {
-    if(map == NULL || keyElement == NULL)
-        return 0; // i.e. this is the first element
-    int i;
-    for(i = 0; i < map->size; i++)  {
-        if(map->compareKeyElements(map->elements[i].key, keyElement) >= 0)
-            return i;
+static MapResult expand(Map map) {
+    return resize(map, EXPAND_FACTOR*(map->max_size));
+}
+
+MapResult mapReserve(Map map, int size) {
+    if(map == NULL)
+        return MAP_NULL_ARGUMENT;
+    if(size <= map->max_size)
+        return MAP_SUCCESS;
+    return resize(map, size);
+}
+
+// the data element to store for a given one: a copy of it, or the element itself when the map takes it over
+static MapDataElement dataToStore(Map map, MapDataElement dataElement, bool copy_data) {
+    if(!copy_data)
+        return dataElement;
+    COUNT(copies);
+    return map->copyDataElement(dataElement);
+}
+
+static MapResult putIntKeyed(Map map, int id, MapDataElement dataElement, bool copy_data) {
+    uint32_t slot = probe(map, id);
+    if(map->slots[slot].data != NULL) {
+        // in case we need to replace data element associated with a given key
+        MapDataElement new_data = dataToStore(map, dataElement, copy_data);
+        if(new_data == NULL){
+            return MAP_OUT_OF_MEMORY;
+        }
+        map->freeDataElement(map->slots[slot].data);
+        map->slots[slot].data = new_data;
+        return MAP_SUCCESS;
     }
-    return map->size;
+    if(map->size == map->max_size) {
+        if(expand(map) != MAP_SUCCESS)
+            return MAP_OUT_OF_MEMORY;
+        slot = probe(map, id);
+    }
+    MapDataElement new_data = dataToStore(map, dataElement, copy_data);
+    if(new_data == NULL) {
+        return MAP_OUT_OF_MEMORY;
+    }
+    int const correct_index = findId(map, id);
+    memmove(&map->ids[correct_index+1], &map->ids[correct_index], (map->size - correct_index)*sizeof(int));
+    map->ids[correct_index] = id;
+    map->slots[slot].id = id;
+    map->slots[slot].data = new_data;
+    map->size++;
+    return MAP_SUCCESS;
 }
 
-MapResult mapPut(Map map, MapKeyElement keyElement, MapDataElement dataElement) {
+static MapResult put(Map map, MapKeyElement keyElement, MapDataElement dataElement, bool copy_data) {
     if(map == NULL || keyElement == NULL || dataElement == NULL)
         return MAP_NULL_ARGUMENT;
-    
-    if(mapContains(map, keyElement)) {
+    if(isIntKeyed(map))
+        return putIntKeyed(map, *(int*)keyElement, dataElement, copy_data);
+
+    int correct_index;
+    int const data_to_replace = find(map, keyElement, &correct_index);
+    if(data_to_replace != ELEMENT_NOT_FOUND) {
         // in case we need to replace data element associated with a given key
-        int data_to_replace = find(map, keyElement);
-        map->freeDataElement(map->elements[data_to_replace].data);
-        map->elements[data_to_replace].data = map->copyDataElement(dataElement);
-        if(map->elements[data_to_replace].data == NULL){
+        MapDataElement new_data = dataToStore(map, dataElement, copy_data);
+        if(new_data == NULL){
             return MAP_OUT_OF_MEMORY;
         }
+        map->freeDataElement(map->elements[data_to_replace].data);
+        map->elements[data_to_replace].data = new_data;
+        return MAP_SUCCESS;
     }
-    else {
-        // in case we need to insert a new element
-        if(map->size == map->max_size) {
-            expand(map);
-        }
-        int const correct_index = findCorrectIndex(map, keyElement);
-        if(correct_index == map->size) {
-            map->size++;
-            map->elements[correct_index].key = map->copyKeyElement(keyElement);
-            map->elements[correct_index].data = map->copyDataElement(dataElement);
-        }
-        else {
-        // reordering the array to make room for the new element in it's right place
-        for(int i = map->size-1; i >= correct_index; i--) {
-            map->elements[i+1].key = map->elements[i].key;
-            map->elements[i+1].data = map->elements[i].data;
-        }
-        map->size++;
-        map->elements[correct_index].key = map->copyKeyElement(keyElement);
-        map->elements[correct_index].data = map->copyDataElement(dataElement);
-        }
+    // in case we need to insert a new element
+    if(map->size == map->max_size && expand(map) != MAP_SUCCESS) {
+        return MAP_OUT_OF_MEMORY;
+    }
+    COUNT(copies);
+    MapKeyElement new_key = map->copyKeyElement(keyElement);
+    if(new_key == NULL) {
+        return MAP_OUT_OF_MEMORY;
+    }
+    MapDataElement new_data = dataToStore(map, dataElement, copy_data);
+    if(new_data == NULL) {
+        map->freeKeyElement(new_key);
+        return MAP_OUT_OF_MEMORY;
     }
+    // reordering the array to make room for the new element in it's right place
+    memmove(&map->elements[correct_index+1], &map->elements[correct_index],
+            (map->size - correct_index)*sizeof(Element));
+    map->elements[correct_index].key = new_key;
+    map->elements[correct_index].data = new_data;
+    map->size++;
     return MAP_SUCCESS;
 }
 
+MapResult mapPut(Map map, MapKeyElement keyElement, MapDataElement dataElement) {
+    return put(map, keyElement, dataElement, true);
+}
+
+MapResult mapPutMove(Map map, MapKeyElement keyElement, MapDataElement dataElement) {
+    return put(map, keyElement, dataElement, false);
+}
+
 
 MapDataElement mapGet(Map map, MapKeyElement keyElement) {
     if (map == NULL || keyElement==NULL)
         return NULL;
-    if (mapContains(map, keyElement) == false)
-        return NULL;
-    
-    int i = find(map, keyElement);
-    if (i == -1) {
+    if (isIntKeyed(map))
+        return map->slots[probe(map, *(int*)keyElement)].data;
+    int i = find(map, keyElement, NULL);
+    if (i == ELEMENT_NOT_FOUND) {
         return NULL;
     }
     return map->elements[i].data;
 }
 
+static MapResult removeIntKeyed(Map map, int id) {
+    uint32_t const slot = probe(map, id);
+    if(map->slots[slot].data == NULL)
+        return MAP_ITEM_DOES_NOT_EXIST;
+    map->freeDataElement(map->slots[slot].data);
+    deleteSlot(map, slot);
+    int const position = findId(map, id);
+    memmove(&map->ids[position], &map->ids[position+1], (map->size - position - 1)*sizeof(int));
+    map->size--;
+    return MAP_SUCCESS;
+}
 
 MapResult mapRemove(Map map, MapKeyElement keyElement ){
     if(map == NULL || keyElement == NULL)
         return MAP_NULL_ARGUMENT;
-    if(!mapContains(map, keyElement))
+    if(isIntKeyed(map))
+        return removeIntKeyed(map, *(int*)keyElement);
+    int element_to_remove = find(map, keyElement, NULL);
+    if(element_to_remove == ELEMENT_NOT_FOUND)
         return MAP_ITEM_DOES_NOT_EXIST;
     // the element exist in the map
 
-    int element_to_remove = find(map, keyElement);
     map->freeDataElement(map->elements[element_to_remove].data);
     map->freeKeyElement(map->elements[element_to_remove].key);
     // element has been removed, now reordering the array
-
-    int i;
-    for(i = element_to_remove+1; i < map->size; i++) {
-        map->elements[i-1] = map->elements[i];
-    }
-    map->freeDataElement(map->elements[i].data);
-    map->freeKeyElement(map->elements[i].key);
-    // frees the last element of the array
+    memmove(&map->elements[element_to_remove], &map->elements[element_to_remove+1],
+            (map->size - element_to_remove - 1)*sizeof(Element));
     map->size--;
     return MAP_SUCCESS;
 }
 
+// the key at a given place in the iteration order, as the pointer the Map interface hands out
+static MapKeyElement keyAt(Map map, int position) {
+    if(isIntKeyed(map))
+        return &map->ids[position];
+    return map->elements[position].key;
+}
+
 MapKeyElement mapGetFirst(Map map) {
     if (map == NULL || map->size == 0) {
         return NULL;
     }
     map->iterator = 0;
-    MapKeyElement first_key_copy = map->copyKeyElement(map->elements[map->iterator].key);
-    return first_key_copy; 
+    COUNT(copies);
+    MapKeyElement first_key_copy = map->copyKeyElement(keyAt(map, map->iterator));
+    return first_key_copy;
 }
 
 MapKeyElement mapGetNext(Map map) {
@@ -229,17 +517,76 @@ MapKeyElement mapGetNext(Map map) {
         return NULL;
     }
     map->iterator++;
-    MapKeyElement key_copy = map->copyKeyElement(map->elements[map->iterator].key);
-    return key_copy; 
+    COUNT(copies);
+    MapKeyElement key_copy = map->copyKeyElement(keyAt(map, map->iterator));
+    return key_copy;
 }
 
-MapResult mapClear(M ap map) {
+MapKeyElement mapBorrowFirst(Map map) {
+    if (map == NULL || map->size == 0) {
+        return NULL;
+    }
+    map->iterator = 0;
+    return keyAt(map, map->iterator);
+}
+
+MapKeyElement mapBorrowNext(Map map) {
+    if (map == NULL || map->iterator >= map->size-1) {
+        return NULL;
+    }
+    map->iterator++;
+    return keyAt(map, map->iterator);
+}
+
+MapDataElement mapGetCurrent(Map map) {
+    if (map == NULL || map->iterator >= map->size) {
+        return NULL;
+    }
+    if (isIntKeyed(map))
+        return map->slots[probe(map, map->ids[map->iterator])].data;
+    return map->elements[map->iterator].data;
+}
+
+MapResult mapClear(Map map) {
     if (map == NULL){
         return MAP_NULL_ARGUMENT;
     }
-    for (int i=0; i < map->size; i++) {
-        map->freeDataElement(map->elements[i].data);
-        map->freeKeyElement(map->elements[i].key);
+    if (isIntKeyed(map)) {
+        for (uint32_t i = 0; i <= map->slots_mask; i++) {
+            if (map->slots[i].data != NULL) {
+                map->freeDataElement(map->slots[i].data);
+                map->slots[i].data = NULL;
+            }
+        }
     }
+    else {
+        for (int i=0; i < map->size; i++) {
+            map->freeDataElement(map->elements[i].data);
+            map->freeKeyElement(map->elements[i].key);
+        }
+    }
+    map->size = 0;
     return MAP_SUCCESS;
 }
+
+void mapGetMetrics(MapMetrics* map_metrics) {
+    if (map_metrics == NULL)
+        return;
+#ifdef CHESS_METRICS
+    map_metrics->comparisons = __atomic_load_n(&metrics.comparisons, __ATOMIC_RELAXED);
+    map_metrics->copies = __atomic_load_n(&metrics.copies, __ATOMIC_RELAXED);
+    map_metrics->allocations = __atomic_load_n(&metrics.allocations, __ATOMIC_RELAXED);
+    map_metrics->expansions = __atomic_load_n(&metrics.expansions, __ATOMIC_RELAXED);
+#else
+    memset(map_metrics, 0, sizeof(*map_metrics));
+#endif
+}
+
+void mapResetMetrics(void) {
+#ifdef CHESS_METRICS
+    __atomic_store_n(&metrics.comparisons, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&metrics.copies, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&metrics.allocations, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&metrics.expansions, 0, __ATOMIC_RELAXED);
+#endif
+}
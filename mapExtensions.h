@@ -0,0 +1,131 @@
+#ifndef MAP_EXTENSIONS_H_
+#define MAP_EXTENSIONS_H_
+
+#include "map.h"
+
+/**
+ * Additions to the generic Map interface declared in map.h, implemented in map/map.c.
+ */
+
+
+/**
+ * mapCreateIntKeyed: allocates a new empty map whose keys are ints.
+ *                    Keys are stored inside the map instead of being copied to the heap, and lookups go
+ *                    through an open addressing hash table, so they take O(1) and make no comparison calls.
+ *                    Every other function of the Map interface works on the returned map as usual,
+ *                    including the ascending key order of MAP_FOREACH. Keys passed to and returned from
+ *                    the map are int*.
+ *
+ * @param copyDataElement - function pointer to be used for copying data elements into the map.
+ * @param freeDataElement - function pointer to be used for removing data elements from the map.
+ *
+ * @return
+ * NULL if one of the parameters is NULL or the allocation failed, or the new map otherwise.
+ *
+ */
+Map mapCreateIntKeyed(copyMapDataElements copyDataElement, freeMapDataElements freeDataElement);
+
+/**
+ * mapPutMove: gives the value of a key, like mapPut, but stores the given data element itself instead of a copy.
+ *             The map takes ownership of the element when it returns MAP_SUCCESS and frees it with the
+ *             free function of the map, so the caller must not use or free it afterwards. On any other
+ *             result the element still belongs to the caller.
+ *
+ * @param map - the map for which to reassign the data element.
+ * @param keyElement - the key element which need to be reassigned. A copy of it is stored in the map.
+ * @param dataElement - the new data element to associate with the given key.
+ *
+ * @return
+ * MAP_NULL_ARGUMENT if a NULL was sent as map, key or data.
+ * MAP_OUT_OF_MEMORY if an allocation failed.
+ * MAP_SUCCESS the map took ownership of the data element.
+ *
+ */
+MapResult mapPutMove(Map map, MapKeyElement keyElement, MapDataElement dataElement);
+
+/**
+ * mapReserve: makes room in the map for a given number of elements at once, so putting that many elements
+ *             makes no further allocations. Elements put in ascending key order are appended at the end
+ *             without moving the others, so filling a map from sorted data is cheap.
+ *
+ * @param map - the map to make room in.
+ * @param size - the number of elements the map should be able to hold.
+ *
+ * @return
+ * MAP_NULL_ARGUMENT if a NULL was sent as map.
+ * MAP_OUT_OF_MEMORY if an allocation failed. The map is left as it was.
+ * MAP_SUCCESS otherwise.
+ *
+ */
+MapResult mapReserve(Map map, int size);
+
+/**
+ * mapBorrowFirst: sets the internal iterator to the first key in the map and returns it, like mapGetFirst,
+ *                 but without copying it. The returned key belongs to the map: it must not be freed or
+ *                 changed, and it is only valid until the map is changed.
+ *
+ * @param map - the map for which to set the iterator and return the first key.
+ *
+ * @return
+ * NULL if a NULL pointer was sent or the map is empty, or the first key of the map otherwise.
+ *
+ */
+MapKeyElement mapBorrowFirst(Map map);
+
+/**
+ * mapBorrowNext: advances the internal iterator and returns the next key, like mapGetNext, without copying it.
+ *                The same rules as for mapBorrowFirst apply to the returned key.
+ *
+ * @param map - the map for which to advance the iterator.
+ *
+ * @return
+ * NULL if a NULL pointer was sent or the iterator reached the end of the map, or the next key otherwise.
+ *
+ */
+MapKeyElement mapBorrowNext(Map map);
+
+/**
+ * mapGetCurrent: returns the data element of the key the internal iterator is at. It does not search the map,
+ *                so it saves the lookup mapGet would make inside a MAP_FOREACH_BORROWED loop.
+ *
+ * @param map - the map whose iterator is used.
+ *
+ * @return
+ * NULL if a NULL pointer was sent or the map is empty, or the data element of the current key otherwise.
+ *
+ */
+MapDataElement mapGetCurrent(Map map);
+
+/** Counts of the work done by all the maps of the process, kept when it is built with CHESS_METRICS */
+typedef struct {
+    unsigned long long comparisons; // keys compared to the searched one, or hash slots probed
+    unsigned long long copies; // calls of the copy functions of keys and data elements
+    unsigned long long allocations; // allocations made by the maps themselves
+    unsigned long long expansions; // times the arrays of a map were grown
+} MapMetrics;
+
+/**
+ * mapGetMetrics: gives the counts of the work done by the maps since the start or the last mapResetMetrics.
+ *                Without CHESS_METRICS nothing is counted, and every count is 0.
+ *
+ * @param map_metrics - the counts to write. Nothing is written if it is NULL.
+ *
+ */
+void mapGetMetrics(MapMetrics* map_metrics);
+
+/**
+ * mapResetMetrics: sets every count of the work done by the maps back to 0.
+ */
+void mapResetMetrics(void);
+
+/**
+ * Macro for iterating over a map without allocating anything.
+ * Declares a new variable to hold each key borrowed from the map (see mapBorrowFirst), so unlike
+ * MAP_FOREACH the iterator must not be freed, and the map must not be changed inside the loop.
+ */
+#define MAP_FOREACH_BORROWED(type, iterator, map) \
+    for(type iterator = (type) mapBorrowFirst(map) ; \
+        iterator ;\
+        iterator = mapBorrowNext(map))
+
+#endif /* MAP_EXTENSIONS_H_ */
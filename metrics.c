@@ -0,0 +1,190 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "chessSystem.h"
+#include "chessSystemExtensions.h"
+#include "map.h"
+#include "mapExtensions.h"
+#include "metrics.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+static const char* const api_names[CHESS_API_NUM] = {
+    [CHESS_API_ADD_TOURNAMENT] = "chessAddTournament",
+    [CHESS_API_REMOVE_TOURNAMENT] = "chessRemoveTournament",
+    [CHESS_API_END_TOURNAMENT] = "chessEndTournament",
+    [CHESS_API_END_TOURNAMENTS] = "chessEndTournaments",
+    [CHESS_API_ADD_GAME] = "chessAddGame",
+    [CHESS_API_ADD_GAMES] = "chessAddGames",
+    [CHESS_API_REMOVE_PLAYER] = "chessRemovePlayer",
+    [CHESS_API_CALCULATE_AVERAGE_PLAY_TIME] = "chessCalculateAveragePlayTime",
+    [CHESS_API_SAVE_PLAYERS_LEVELS] = "chessSavePlayersLevels",
+    [CHESS_API_SAVE_TOURNAMENT_STATISTICS] = "chessSaveTournamentStatistics",
+    [CHESS_API_GET_TOP_PLAYERS] = "chessGetTopPlayers",
+    [CHESS_API_GET_PLAYER_RANK] = "chessGetPlayerRank",
+    [CHESS_API_GET_PLAYER_LEVEL] = "chessGetPlayerLevel"
+};
+
+static const char* const result_names[CHESS_SUCCESS + 1] = {
+    [CHESS_OUT_OF_MEMORY] = "CHESS_OUT_OF_MEMORY",
+    [CHESS_NULL_ARGUMENT] = "CHESS_NULL_ARGUMENT",
+    [CHESS_INVALID_ID] = "CHESS_INVALID_ID",
+    [CHESS_INVALID_LOCATION] = "CHESS_INVALID_LOCATION",
+    [CHESS_INVALID_MAX_GAMES] = "CHESS_INVALID_MAX_GAMES",
+    [CHESS_TOURNAMENT_ALREADY_EXISTS] = "CHESS_TOURNAMENT_ALREADY_EXISTS",
+    [CHESS_TOURNAMENT_NOT_EXIST] = "CHESS_TOURNAMENT_NOT_EXIST",
+    [CHESS_GAME_ALREADY_EXISTS] = "CHESS_GAME_ALREADY_EXISTS",
+    [CHESS_INVALID_PLAY_TIME] = "CHESS_INVALID_PLAY_TIME",
+    [CHESS_EXCEEDED_GAMES] = "CHESS_EXCEEDED_GAMES",
+    [CHESS_PLAYER_NOT_EXIST] = "CHESS_PLAYER_NOT_EXIST",
+    [CHESS_TOURNAMENT_ENDED] = "CHESS_TOURNAMENT_ENDED",
+    [CHESS_NO_TOURNAMENTS_ENDED] = "CHESS_NO_TOURNAMENTS_ENDED",
+    [CHESS_NO_GAMES] = "CHESS_NO_GAMES",
+    [CHESS_SAVE_FAILURE] = "CHESS_SAVE_FAILURE",
+    [CHESS_SUCCESS] = "CHESS_SUCCESS"
+};
+
+// the percentiles of the latencies that are printed
+static const double percentiles[] = { 0.5, 0.9, 0.99, 0.999 };
+static const char* const percentile_names[] = { "p50", "p90", "p99", "p999" };
+
+#define PERCENTILES_NUM ((int)(sizeof(percentiles) / sizeof(percentiles[0])))
+
+// the counts of the calls. they may be updated by several threads at once, which don't need to agree on their
+// order, so every count is updated on its own with a relaxed atomic operation
+static ChessApiMetrics apis[CHESS_API_NUM];
+
+#define ADD(counter, amount) __atomic_fetch_add(&(counter), (amount), __ATOMIC_RELAXED)
+#define LOAD(counter) __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+#define STORE(counter, value) __atomic_store_n(&(counter), (value), __ATOMIC_RELAXED)
+
+uint64_t metricsNow(void) {
+#ifdef CHESS_METRICS_TIMERS
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000u + time.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+#ifdef CHESS_METRICS_TIMERS
+// the bucket of a latency is the position of its highest set bit
+static int latencyBucket(uint64_t latency) {
+    int bucket = 0;
+    while (bucket < CHESS_LATENCY_BUCKETS - 1 && (latency >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+    return bucket;
+}
+#endif
+
+void metricsRecord(ChessApi api, ChessResult result, uint64_t start) {
+    ADD(apis[api].calls, 1);
+    ADD(apis[api].results[result], 1);
+#ifdef CHESS_METRICS_TIMERS
+    uint64_t latency = metricsNow() - start;
+    ADD(apis[api].total_ns, latency);
+    ADD(apis[api].latency_buckets[latencyBucket(latency)], 1);
+#endif
+}
+
+void metricsGet(ChessMetrics* metrics) {
+    memset(metrics, 0, sizeof(*metrics));
+#ifdef CHESS_METRICS
+    metrics->is_counted = true;
+#endif
+#ifdef CHESS_METRICS_TIMERS
+    metrics->is_timed = true;
+#endif
+    MapMetrics map_metrics;
+    mapGetMetrics(&map_metrics);
+    metrics->map_comparisons = map_metrics.comparisons;
+    metrics->map_copies = map_metrics.copies;
+    metrics->map_allocations = map_metrics.allocations;
+    metrics->map_expansions = map_metrics.expansions;
+    for (int api = 0; api < CHESS_API_NUM; api++) {
+        metrics->apis[api].calls = LOAD(apis[api].calls);
+        for (int result = 0; result <= CHESS_SUCCESS; result++) {
+            metrics->apis[api].results[result] = LOAD(apis[api].results[result]);
+        }
+        metrics->apis[api].total_ns = LOAD(apis[api].total_ns);
+        for (int bucket = 0; bucket < CHESS_LATENCY_BUCKETS; bucket++) {
+            metrics->apis[api].latency_buckets[bucket] = LOAD(apis[api].latency_buckets[bucket]);
+        }
+    }
+}
+
+void metricsReset(void) {
+    mapResetMetrics();
+    for (int api = 0; api < CHESS_API_NUM; api++) {
+        STORE(apis[api].calls, 0);
+        for (int result = 0; result <= CHESS_SUCCESS; result++) {
+            STORE(apis[api].results[result], 0);
+        }
+        STORE(apis[api].total_ns, 0);
+        for (int bucket = 0; bucket < CHESS_LATENCY_BUCKETS; bucket++) {
+            STORE(apis[api].latency_buckets[bucket], 0);
+        }
+    }
+}
+
+// the end of the bucket of the histogram that a fraction of the timed calls fall in, or 0 if no call was timed
+static unsigned long long bucketEnd(const ChessApiMetrics* api_metrics, unsigned long long timed_calls,
+                                    double fraction) {
+    unsigned long long calls = 0;
+    for (int bucket = 0; bucket < CHESS_LATENCY_BUCKETS; bucket++) {
+        calls += api_metrics->latency_buckets[bucket];
+        if (calls > 0 && calls >= fraction * timed_calls) {
+            return 1ull << (bucket + 1);
+        }
+    }
+    return 0;
+}
+
+static void printLatencies(const char* name, const ChessApiMetrics* api_metrics, FILE* file) {
+    unsigned long long timed_calls = 0;
+    for (int bucket = 0; bucket < CHESS_LATENCY_BUCKETS; bucket++) {
+        timed_calls += api_metrics->latency_buckets[bucket];
+    }
+    if (timed_calls == 0) {
+        return;
+    }
+    fprintf(file, "%s latency mean_ns=%.0f", name, (double)api_metrics->total_ns / timed_calls);
+    for (int i = 0; i < PERCENTILES_NUM; i++) {
+        fprintf(file, " %s_ns<%llu", percentile_names[i], bucketEnd(api_metrics, timed_calls, percentiles[i]));
+    }
+    fprintf(file, "\n%s histogram_ns", name);
+    for (int bucket = 0; bucket < CHESS_LATENCY_BUCKETS; bucket++) {
+        if (api_metrics->latency_buckets[bucket] > 0) {
+            fprintf(file, " [%llu,%llu)=%llu", bucket == 0 ? 0 : 1ull << bucket, 1ull << (bucket + 1),
+                    api_metrics->latency_buckets[bucket]);
+        }
+    }
+    fprintf(file, "\n");
+}
+
+ChessResult metricsPrint(const ChessMetrics* metrics, FILE* file) {
+    if (!metrics->is_counted) {
+        fprintf(file, "metrics are not counted, build with -DCHESS_METRICS\n");
+    }
+    fprintf(file, "map comparisons=%llu copies=%llu allocations=%llu expansions=%llu\n", metrics->map_comparisons,
+            metrics->map_copies, metrics->map_allocations, metrics->map_expansions);
+    for (int api = 0; api < CHESS_API_NUM; api++) {
+        const ChessApiMetrics* api_metrics = &metrics->apis[api];
+        if (api_metrics->calls == 0) {
+            continue;
+        }
+        fprintf(file, "%s calls=%llu", api_names[api], api_metrics->calls);
+        for (int result = 0; result <= CHESS_SUCCESS; result++) {
+            if (api_metrics->results[result] > 0) {
+                fprintf(file, " %s=%llu", result_names[result], api_metrics->results[result]);
+            }
+        }
+        fprintf(file, "\n");
+        printLatencies(api_names[api], api_metrics, file);
+    }
+    return ferror(file) ? CHESS_SAVE_FAILURE : CHESS_SUCCESS;
+}
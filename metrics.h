@@ -0,0 +1,76 @@
+#ifndef _METRICS_H
+#define _METRICS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * Counters of the calls of the chess system functions, read by chessGetMetrics. They are only kept when the
+ * system is built with -DCHESS_METRICS, and the calls are timed only with -DCHESS_METRICS_TIMERS as well.
+ * A function is counted by starting a timer when it's called and recording its result before it returns:
+ *
+ *     METRICS_START(start);
+ *     ChessResult result = ...;
+ *     METRICS_RECORD(CHESS_API_..., result, start);
+ *
+ * Without CHESS_METRICS both macros expand to nothing, so the counted functions are compiled as if they weren't.
+ */
+
+#if defined(CHESS_METRICS_TIMERS) && !defined(CHESS_METRICS)
+#error "CHESS_METRICS_TIMERS needs CHESS_METRICS"
+#endif
+
+#ifdef CHESS_METRICS
+#define METRICS_START(start) uint64_t const start = metricsNow()
+#define METRICS_RECORD(api, result, start) metricsRecord((api), (result), (start))
+#else
+#define METRICS_START(start)
+#define METRICS_RECORD(api, result, start)
+#endif
+
+
+/**
+ * metricsNow: reads the clock the calls are timed with.
+ *
+ * @return
+ * the time in nanoseconds since an arbitrary point, or 0 if the calls aren't timed.
+ */
+uint64_t metricsNow(void);
+
+/**
+ * metricsRecord: counts a call of a function, and its latency if the calls are timed.
+ *
+ * @param api - the function that was called.
+ * @param result - the result the call returned.
+ * @param start - the time the call started, given by metricsNow.
+ *
+ */
+void metricsRecord(ChessApi api, ChessResult result, uint64_t start);
+
+/**
+ * metricsGet: gives the counts of the calls and of the work done by the maps.
+ *
+ * @param metrics - the counts to write.
+ *
+ */
+void metricsGet(ChessMetrics* metrics);
+
+/**
+ * metricsReset: sets every count back to 0.
+ */
+void metricsReset(void);
+
+/**
+ * metricsPrint: prints counts as text.
+ *
+ * @param metrics - the counts to print.
+ * @param file - the file to print to.
+ *
+ * @return
+ * CHESS_SAVE_FAILURE if writing to the file failed.
+ * CHESS_SUCCESS otherwise.
+ *
+ */
+ChessResult metricsPrint(const ChessMetrics* metrics, FILE* file);
+
+#endif //_METRICS_H
@@ -0,0 +1,156 @@
+#include "pairSet.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#define INITIAL_BITS 4
+#define EMPTY_PAIR 0 // ids are positive, so no pair is ever 0
+#define HASH_MULTIPLIER UINT64_C(0x9E3779B97F4A7C15)
+#define HASH_BITS 64
+
+// an open addressing hash table of pairs, each packed into 64 bits with the smaller id first
+struct pair_set_t {
+    uint64_t* pairs;
+    int size;
+    int bits;
+};
+
+static uint64_t pack(int first_player, int second_player) {
+    if (first_player > second_player) {
+        int temp = first_player;
+        first_player = second_player;
+        second_player = temp;
+    }
+    return ((uint64_t)(uint32_t)first_player << 32) | (uint32_t)second_player;
+}
+
+static uint64_t mask(PairSet set) {
+    return ((uint64_t)1 << set->bits) - 1;
+}
+
+static uint64_t hashSlot(PairSet set, uint64_t pair) {
+    return (pair * HASH_MULTIPLIER) >> (HASH_BITS - set->bits);
+}
+
+// the slot that holds the pair, or the empty slot that ends its probe sequence
+static uint64_t probe(PairSet set, uint64_t pair) {
+    uint64_t slot = hashSlot(set, pair);
+    while (set->pairs[slot] != EMPTY_PAIR && set->pairs[slot] != pair) {
+        slot = (slot + 1) & mask(set);
+    }
+    return slot;
+}
+
+static PairSet pairSetAllocate(int bits) {
+    PairSet set = malloc(sizeof(*set));
+    if (set == NULL) {
+        return NULL;
+    }
+    set->pairs = calloc((size_t)1 << bits, sizeof(*set->pairs));
+    if (set->pairs == NULL) {
+        free(set);
+        return NULL;
+    }
+    set->size = 0;
+    set->bits = bits;
+    return set;
+}
+
+PairSet pairSetCreate() {
+    return pairSetAllocate(INITIAL_BITS);
+}
+
+PairSet pairSetCopy(PairSet set) {
+    assert(set != NULL);
+    PairSet new_set = pairSetAllocate(set->bits);
+    if (new_set == NULL) {
+        return NULL;
+    }
+    memcpy(new_set->pairs, set->pairs, sizeof(*set->pairs) << set->bits);
+    new_set->size = set->size;
+    return new_set;
+}
+
+void pairSetDestroy(PairSet set) {
+    if (set == NULL) {
+        return;
+    }
+    free(set->pairs);
+    free(set);
+}
+
+bool pairSetContains(PairSet set, int first_player, int second_player) {
+    uint64_t pair = pack(first_player, second_player);
+    return set->pairs[probe(set, pair)] == pair;
+}
+
+// moves the pairs to a table of 2^bits slots
+static bool rehash(PairSet set, int bits) {
+    uint64_t* old_pairs = set->pairs;
+    uint64_t old_mask = mask(set);
+    set->pairs = calloc((size_t)1 << bits, sizeof(*set->pairs));
+    if (set->pairs == NULL) {
+        set->pairs = old_pairs;
+        return false;
+    }
+    set->bits = bits;
+    for (uint64_t i = 0; i <= old_mask; i++) {
+        if (old_pairs[i] != EMPTY_PAIR) {
+            set->pairs[probe(set, old_pairs[i])] = old_pairs[i];
+        }
+    }
+    free(old_pairs);
+    return true;
+}
+
+// doubles the table, keeping it at most half full
+static bool grow(PairSet set) {
+    return rehash(set, set->bits + 1);
+}
+
+bool pairSetReserve(PairSet set, int size) {
+    int bits = set->bits;
+    while (2*(uint64_t)size > ((uint64_t)1 << bits)) {
+        bits++;
+    }
+    return bits == set->bits || rehash(set, bits);
+}
+
+bool pairSetAdd(PairSet set, int first_player, int second_player) {
+    assert(first_player > 0 && second_player > 0);
+    if (2*(uint64_t)(set->size + 1) > mask(set) + 1 && !grow(set)) {
+        return false;
+    }
+    uint64_t pair = pack(first_player, second_player);
+    uint64_t slot = probe(set, pair);
+    if (set->pairs[slot] == EMPTY_PAIR) {
+        set->pairs[slot] = pair;
+        set->size++;
+    }
+    return true;
+}
+
+void pairSetRemove(PairSet set, int first_player, int second_player) {
+    uint64_t hole = probe(set, pack(first_player, second_player));
+    if (set->pairs[hole] == EMPTY_PAIR) {
+        return;
+    }
+    // shift the rest of the cluster back over the hole, so no tombstones are needed
+    uint64_t slot = hole;
+    while (true) {
+        slot = (slot + 1) & mask(set);
+        if (set->pairs[slot] == EMPTY_PAIR) {
+            break;
+        }
+        uint64_t home = hashSlot(set, set->pairs[slot]);
+        if (((slot - home) & mask(set)) >= ((slot - hole) & mask(set))) {
+            set->pairs[hole] = set->pairs[slot];
+            hole = slot;
+        }
+    }
+    set->pairs[hole] = EMPTY_PAIR;
+    set->size--;
+}
@@ -0,0 +1,81 @@
+#ifndef _PAIR_SET_H
+#define _PAIR_SET_H
+
+#include <stdbool.h>
+
+/** Type for a set of unordered pairs of player ids, such as the pairs that played each other in a tournament */
+typedef struct pair_set_t *PairSet;
+
+
+/**
+ * pairSetCreate: allocates a new empty set of pairs.
+ *
+ * @return NULL if the allocation failed, or the new set otherwise.
+ *
+ */
+PairSet pairSetCreate();
+
+/**
+ * pairSetCopy: duplicate a given set of pairs.
+ *
+ * @param set - the set that is copied. Must be non-NULL.
+ *
+ * @return NULL if the allocation failed, or the new set otherwise.
+ *
+ */
+PairSet pairSetCopy(PairSet set);
+
+/**
+ * pairSetDestroy: frees a set of pairs and all its resources.
+ *
+ * @param set - the set to free. May be NULL.
+ *
+ */
+void pairSetDestroy(PairSet set);
+
+/**
+ * pairSetContains: checks in O(1) if a pair is in the set. The order of the two ids doesn't matter.
+ *
+ * @param set - the set that is checked.
+ * @param first_player - the id of one player of the pair. Must be positive.
+ * @param second_player - the id of the other player of the pair. Must be positive.
+ *
+ * @return TRUE if the pair is in the set, or FALSE if not.
+ *
+ */
+bool pairSetContains(PairSet set, int first_player, int second_player);
+
+/**
+ * pairSetAdd: adds a pair to the set. Adding a pair that is already in the set changes nothing.
+ *
+ * @param set - the set to add to.
+ * @param first_player - the id of one player of the pair. Must be positive.
+ * @param second_player - the id of the other player of the pair. Must be positive.
+ *
+ * @return FALSE if the set had to grow and the allocation failed, or TRUE otherwise.
+ *
+ */
+bool pairSetAdd(PairSet set, int first_player, int second_player);
+
+/**
+ * pairSetReserve: makes room in the set for a given number of pairs at once, so adding them doesn't grow it again.
+ *
+ * @param set - the set to make room in.
+ * @param size - the number of pairs the set should be able to hold.
+ *
+ * @return FALSE if the allocation failed, and the set is left as it was, or TRUE otherwise.
+ *
+ */
+bool pairSetReserve(PairSet set, int size);
+
+/**
+ * pairSetRemove: removes a pair from the set, if it is there.
+ *
+ * @param set - the set to remove from.
+ * @param first_player - the id of one player of the pair.
+ * @param second_player - the id of the other player of the pair.
+ *
+ */
+void pairSetRemove(PairSet set, int first_player, int second_player);
+
+#endif //_PAIR_SET_H
@@ -0,0 +1,79 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "parallel.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define MAX_THREADS 64
+
+// the share of a thread in a parallel loop: the indexes first, first + stride, first + 2 * stride and so on
+typedef struct {
+    int first;
+    int stride;
+    int count;
+    ParallelTask task;
+    void* context;
+    pthread_t thread;
+    bool is_started;
+} Worker;
+
+static void runWorker(Worker* worker) {
+    for (int index = worker->first; index < worker->count; index += worker->stride) {
+        worker->task(index, worker->context);
+    }
+}
+
+static void* workerMain(void* worker) {
+    runWorker(worker);
+    return NULL;
+}
+
+int parallelGetThreadsNum() {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1) {
+        return 1;
+    }
+    return cores > MAX_THREADS ? MAX_THREADS : (int)cores;
+}
+
+void parallelFor(int count, ParallelTask task, void* context, int max_threads) {
+    int threads_num = parallelGetThreadsNum();
+    if (threads_num > max_threads) {
+        threads_num = max_threads;
+    }
+    if (threads_num > count) {
+        threads_num = count;
+    }
+    if (threads_num <= 1) {
+        for (int index = 0; index < count; index++) {
+            task(index, context);
+        }
+        return;
+    }
+
+    Worker workers[MAX_THREADS];
+    for (int i = 0; i < threads_num; i++) {
+        workers[i].first = i;
+        workers[i].stride = threads_num;
+        workers[i].count = count;
+        workers[i].task = task;
+        workers[i].context = context;
+        workers[i].is_started = false;
+    }
+    // the calling thread is the first worker
+    for (int i = 1; i < threads_num; i++) {
+        workers[i].is_started = pthread_create(&workers[i].thread, NULL, workerMain, &workers[i]) == 0;
+    }
+    runWorker(&workers[0]);
+    for (int i = 1; i < threads_num; i++) {
+        if (workers[i].is_started) {
+            pthread_join(workers[i].thread, NULL);
+        }
+        else {
+            runWorker(&workers[i]);
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef _PARALLEL_H
+#define _PARALLEL_H
+
+/** Type of a task that is run for every index of a parallel loop */
+typedef void (*ParallelTask)(int index, void* context);
+
+
+/**
+ * parallelGetThreadsNum: gives the number of threads a parallel loop may use, which is the number of online cores.
+ *
+ * @return the number of threads, at least 1.
+ *
+ */
+int parallelGetThreadsNum();
+
+/**
+ * parallelFor: runs a task for every index from 0 to count - 1, split between a group of threads.
+ *              The calling thread takes part, and returns after every index was done. Tasks of different
+ *              indexes run at the same time, so they must not change shared data without synchronization.
+ *              If a thread can't be started, its indexes are run by the calling thread, so every index
+ *              is always done.
+ *
+ * @param count - the number of indexes.
+ * @param task - the function run for every index.
+ * @param context - passed as is to every call of task.
+ * @param max_threads - the maximum number of threads to use, including the calling thread.
+ *                      With 1 or less the loop runs in the calling thread only.
+ *
+ */
+void parallelFor(int count, ParallelTask task, void* context, int max_threads);
+
+#endif //_PARALLEL_H
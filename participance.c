@@ -1,5 +1,11 @@
 #include "chessSystem.h"
 #include "map.h"
+#include "mapExtensions.h"
+#include "pool.h"
+#include "pairSet.h"
+#include "leaderboard.h"
+#include "rankTable.h"
+#include "parallel.h"
 #include "tournament.h"
 #include "game.h"
 #include "player.h"
@@ -11,66 +17,78 @@
 #include <stdbool.h>
 #include <assert.h>
 
+#define INITIAL_GAMES_CAPACITY 4
+
 struct participance_t {
-    int *tour_id;
+    int tour_id;
     int num_of_games;
     int wins;
     int losses;
     int draws;
+    int* game_ids;
+    int games_capacity;
+    int rank_row;
+    Pool pool;
 };
 
-Participance participanceCreate(Map participances, int tour_id) {
-    Participance participance = malloc(sizeof(*participance));
+Pool participancePoolCreate() {
+    return poolCreate(sizeof(struct participance_t));
+}
+
+Participance participanceCreate(Pool pool, int tour_id) {
+    Participance participance = poolAlloc(pool);
     if (participance == NULL) {
         return NULL;
     }
-    participance->tour_id = malloc(sizeof(*(participance->tour_id)));
-    if (participance->tour_id == NULL) {
-        free(participance);
-        return NULL;
-    }
-    *(participance->tour_id) = tour_id;
+    participance->pool = pool;
+    participance->tour_id = tour_id;
     participance->num_of_games = 0;
     participance->wins = 0;
     participance->losses = 0;
     participance->draws = 0;
+    participance->game_ids = NULL;
+    participance->games_capacity = 0;
+    participance->rank_row = 0;
 
     return participance; 
 }
     
 MapDataElement participanceCopy(MapDataElement participance_to_copy) {
-    Participance new_participance = malloc(sizeof(*new_participance));
+    Participance participance = participance_to_copy;
+    Participance new_participance = poolAlloc(participance->pool);
     if (new_participance == NULL){
         return NULL;
     }
 
-    new_participance->tour_id = malloc(sizeof(*(new_participance->tour_id)));
-    if (new_participance->tour_id == NULL) {
-        free(new_participance);
-        return NULL;
-    }
-    Participance participance = participance_to_copy;
-
-    *(new_participance->tour_id) = *(participance->tour_id);
+    new_participance->pool = participance->pool;
+    new_participance->tour_id = participance->tour_id;
     new_participance->num_of_games = participance->num_of_games;
     new_participance->wins = participance->wins;
     new_participance->losses = participance->losses;
     new_participance->draws = participance->draws;
+    new_participance->games_capacity = participance->games_capacity;
+    new_participance->rank_row = participance->rank_row;
+    new_participance->game_ids = NULL;
+    if (participance->games_capacity > 0) {
+        new_participance->game_ids = malloc(sizeof(int)*participance->games_capacity);
+        if (new_participance->game_ids == NULL) {
+            poolFree(new_participance->pool, new_participance);
+            return NULL;
+        }
+        memcpy(new_participance->game_ids, participance->game_ids, sizeof(int)*participance->num_of_games);
+    }
 
     return (MapDataElement)new_participance; 
 }
 
 void participanceDestroy(MapDataElement generic_participance) {
     Participance participance = generic_participance;
-    free(participance->tour_id);
-    free(participance);
+    free(participance->game_ids);
+    poolFree(participance->pool, participance);
 }
 
-int* participanceGetId(Participance participance) {
-    int* id = malloc(sizeof(id));
-    *id = *(participance->tour_id);
-    
-    return id; 
+int participanceGetId(Participance participance) {
+    return participance->tour_id;
 }
 
 int participanceGetWins(Participance participance) {
@@ -89,22 +107,63 @@ int participanceGetNumOfGames(Participance participance) {
     return participance->num_of_games;
 }
 
-void participanceRaiseNumOfGames(Map participances, int tournament_id) {
-    assert (participances != NULL); 
-    Participance participance = mapGet(participances, &tournament_id);
+int participanceGetRankRow(Participance participance) {
+    return participance->rank_row;
+}
+
+void participanceSetRankRow(Participance participance, int rank_row) {
+    participance->rank_row = rank_row;
+}
+
+const int* participanceGetGames(Participance participance) {
+    return participance->game_ids;
+}
+
+bool participanceReserveGame(Participance participance) {
+    if (participance->num_of_games < participance->games_capacity) {
+        return true;
+    }
+    int new_capacity = participance->games_capacity == 0 ? INITIAL_GAMES_CAPACITY : 2*participance->games_capacity;
+    int* new_game_ids = realloc(participance->game_ids, sizeof(int)*new_capacity);
+    if (new_game_ids == NULL) {
+        return false;
+    }
+    participance->game_ids = new_game_ids;
+    participance->games_capacity = new_capacity;
+    return true;
+}
+
+void participanceRaiseNumOfGames(Participance participance, int game_id) {
+    assert (participance != NULL);
+    assert (participance->num_of_games < participance->games_capacity);
+    participance->game_ids[participance->num_of_games] = game_id;
     (participance->num_of_games)++;
 }
 
-void participanceWinnerUpdate(Map winner_participances, Map loser_participances, int tour_id) {
-    Participance winner_participance = mapGet(winner_participances, &tour_id);
-    Participance loser_participance = mapGet(loser_participances, &tour_id);
+bool participanceRestore(Participance participance, int wins, int losses, int draws,
+                         const int* game_ids, int num_of_games) {
+    assert (participance->num_of_games == 0);
+    if (num_of_games > 0) {
+        participance->game_ids = malloc(sizeof(int)*num_of_games);
+        if (participance->game_ids == NULL) {
+            return false;
+        }
+        memcpy(participance->game_ids, game_ids, sizeof(int)*num_of_games);
+        participance->games_capacity = num_of_games;
+    }
+    participance->num_of_games = num_of_games;
+    participance->wins = wins;
+    participance->losses = losses;
+    participance->draws = draws;
+    return true;
+}
+
+void participanceWinnerUpdate(Participance winner_participance, Participance loser_participance) {
     winner_participance->wins++;
     loser_participance->losses++;
 }
 
-void participanceDrawUpdate(Map player1_participances, Map player2_participances, int tour_id) {
-    Participance player1_participance = mapGet(player1_participances, &tour_id);
-    Participance player2_participance = mapGet(player2_participances, &tour_id);
+void participanceDrawUpdate(Participance player1_participance, Participance player2_participance) {
     player1_participance->draws++;
     player2_participance->draws++;
 }
@@ -2,23 +2,32 @@
 #define _PARTICIPANCE_H
 
 #include <stdio.h>
+#include <stdbool.h>
 
 typedef struct participance_t *Participance;
 
 
+/**
+ * participancePoolCreate: allocates a new empty pool to allocate the participances in a tournament from.
+ *
+ * @return NULL if the allocation failed, or the new pool otherwise.
+ *
+ */
+Pool participancePoolCreate();
+
 /**
  * participanceCreate: allocates a new participance for a certain player.
  * 
- * @param particpances - the map to which the particpance is added.
+ * @param pool - the pool of participances of the tournament. Must be created with participancePoolCreate.
  * @param tour_id - the id that the future participance will obtain.
  *
  * @return NULL if the allocation failed, or a pointer to the new participance that was created otherwise.
  *
  */
-Participance participanceCreate(Map participances, int tour_id);
+Participance participanceCreate(Pool pool, int tour_id);
 
 /**
- * participanceCopy: duplicate a given participance - allocate a new one and copy the data.
+ * participanceCopy: duplicate a given participance - allocate a new one from the same pool and copy the data.
  *
  * @param participance_to_copy - the participance that is copied. Must be non-NULL.
  * 
@@ -29,7 +38,7 @@ Participance participanceCreate(Map participances, int tour_id);
 MapDataElement participanceCopy(MapDataElement participance_to_copy);
 
 /** 
- * participanceDestroy: frees all resources of a participance of a certain player in a certain tournament.
+ * participanceDestroy: returns a participance of a certain player in a certain tournament to its pool.
  * 
  * @param participance - the participance that is going to be deleted.
  * 
@@ -44,7 +53,7 @@ void participanceDestroy(MapDataElement generic_participance);
  * @return the id of the participance.
  *
  */
-int* participanceGetId(Participance participance);
+int participanceGetId(Participance participance);
 
 /**
  * participanceGetWins: gives the number of games a certain player won in a certain tourament.
@@ -87,37 +96,96 @@ int participanceGetDraws(Participance participance);
 int participanceGetNumOfGames(Participance participance);
 
 /**
- * participanceRaiseNumOfGames: raises the number of games a certain player played in a certain tourament by one.
+ * participanceGetRankRow: gives the row of a certain player in the standings of a certain tournament.
+ * 
+ * @param participance - the participance of the player of which we would get the row.
+ * 
+ * @return the row of the player in the rank table of the tournament.
+ *
+ */
+int participanceGetRankRow(Participance participance);
+
+/**
+ * participanceSetRankRow: sets the row of a certain player in the standings of a certain tournament.
+ * 
+ * @param participance - the participance of the player of which the row is set.
+ * @param rank_row - the row of the player in the rank table of the tournament.
+ *
+ */
+void participanceSetRankRow(Participance participance, int rank_row);
+
+/**
+ * participanceGetGames: gives the ids of the games a certain player played in a certain tournament,
+ *                       in the order they were added.
+ * 
+ * @param participance - the participance of the player of which we would get the games.
+ * 
+ * @return an array of participanceGetNumOfGames(participance) game ids, that belongs to the participance
+ *         and is valid until the next change of it.
+ *
+ */
+const int* participanceGetGames(Participance participance);
+
+/**
+ * participanceReserveGame: makes sure there is room for one more game in a certain participance, so the
+ *                          following participanceRaiseNumOfGames can't fail.
+ * 
+ * @param participance - the participance a game would be added to.
+ * 
+ * @return false if the allocation failed, or true otherwise.
+ *
+ */
+bool participanceReserveGame(Participance participance);
+
+/**
+ * participanceRaiseNumOfGames: raises the number of games a certain player played in a certain tourament by one,
+ *                              and adds the game to the games of the participance.
+ *                              participanceReserveGame must be called before.
  * 
  * @param participance - the participance of which the number of games would be raised.
+ * @param game_id - the id of the game that was played.
+ *
+ */
+void participanceRaiseNumOfGames(Participance participance, int game_id);
+
+/**
+ * participanceRestore: sets the results and the games of a new participance, as they were saved by a snapshot
+ *                      of the system.
+ * 
+ * @param participance - a participance with no games yet.
+ * @param wins - the number of games the player won in the tournament.
+ * @param losses - the number of games the player lost in the tournament.
+ * @param draws - the number of games of the player in the tournament that ended with a draw.
+ * @param game_ids - the ids of the games of the player in the tournament, in the order they were added. Copied.
+ * @param num_of_games - the number of game ids.
+ * 
+ * @return false if the allocation failed, and the participance is left with no games, or true otherwise.
  *
  */
-void participanceRaiseNumOfGames(Map participances, int tournament_id);
+bool participanceRestore(Participance participance, int wins, int losses, int draws,
+                         const int* game_ids, int num_of_games);
 
 /**
  * participanceWinnerUpdate: raises the number of wins for the winner and the number of losses
- *                           for the loser, at their participance in a certain game- that belongs
- *                           to a certain tournament.
+ *                           for the loser, at their participances in the tournament of a certain game.
  * 
- * @param winner_participance - the map of participances of the player who won- in which the number of wins will
- *                              be raised, respectively to the tournament id.
- * @param winner_participance - the map of participances of the player who lost- in which the number of losses will
- *                              be raised, respectively to the tournament id.
- * @param tour_id - the id of the participance of which the number of wins and losses are going to be raised.
+ * @param winner_participance - the participance of the player who won, in which the number of wins will
+ *                              be raised.
+ * @param loser_participance - the participance of the player who lost, in which the number of losses will
+ *                             be raised.
  * 
  */
-void participanceWinnerUpdate(Map winner_participances, Map loser_participances, int tour_id);
+void participanceWinnerUpdate(Participance winner_participance, Participance loser_participance);
 
 /**
- * participanceDrawUpdate: raises the number of draws for both players at their participance in a certain game-
- *                           that belongs to a certain tournament.
+ * participanceDrawUpdate: raises the number of draws for both players at their participances in the tournament
+ *                         of a certain game.
  * 
- * @param player1_participances - the map of participances of the first player in the game where the score was a draw.
- * @param player2_participances - the map of participances of the second player in the game where the score was a draw.
- * @param tour_id - the id of the participance of which the number draws is going to be raised.
+ * @param player1_participance - the participance of the first player in the game where the score was a draw.
+ * @param player2_participance - the participance of the second player in the game where the score was a draw.
  * 
  */
-void participanceDrawUpdate(Map player1_participances, Map player2_participances, int tour_id);
+void participanceDrawUpdate(Participance player1_participance, Participance player2_participance);
 
 
 #endif //_PARTICIPANCE_H
@@ -1,5 +1,11 @@
 #include "chessSystem.h"
 #include "map.h"
+#include "mapExtensions.h"
+#include "pool.h"
+#include "pairSet.h"
+#include "leaderboard.h"
+#include "rankTable.h"
+#include "parallel.h"
 #include "tournament.h"
 #include "game.h"
 #include "player.h"
@@ -11,18 +17,23 @@
 #include <stdbool.h>
 #include <assert.h>
 
-#define NUM_OF_COMPONENTS 2
-#define LEVEL 0
-#define ID 1
+#define UNDEFINED -1
 
 struct player_t{
-    int* player_id;
+    int player_id;
     int num_wins;
     int num_losses;
     int num_draws;
     int num_of_games;
     double play_time;
+    // the level his results give, kept with them so it's never calculated again from them
+    double level;
     Map participances;
+    // while a batch of games defers moving the player in the leaderboard, the level he is filed under there
+    double filed_level;
+    bool is_move_deferred;
+    // odd while updatePlayersData changes the results above, so playerReadResults can read them without locks
+    unsigned version;
 };
 
 Player playerCreate(int id) {
@@ -30,19 +41,16 @@ Player playerCreate(int id) {
     if(player == NULL)
         return NULL;
     
-    player->player_id = malloc(sizeof(*(player->player_id)));
-    if (player->player_id == NULL){
-        free(player->player_id);
-        return NULL;
-    }
-    Map participances = mapCreate(participanceCopy, idCopy, participanceDestroy, idFree, idCompare);
+    Map participances = mapCreateIntKeyed(participanceCopy, participanceDestroy);
     if(participances == NULL){
-        free(player->player_id);
         free(player);
         return NULL;
     }
     player->participances = participances;
-    *(player->player_id) = id;
+    player->player_id = id;
+    player->level = 0;
+    player->is_move_deferred = false;
+    player->version = 0;
     return player;
 }
 
@@ -57,16 +65,10 @@ MapDataElement playerCopy(MapDataElement player_to_copy) {
         return NULL;
     }
 
-    new_player->player_id = malloc(sizeof(*(new_player->player_id)));
-    if (new_player->player_id == NULL){
-        free(new_player);
-        return NULL;
-    }
-    *(new_player->player_id) = *(player->player_id);
+    new_player->player_id = player->player_id;
 
     new_player->participances = mapCopy(player->participances);
     if (new_player->participances == NULL){
-        free(new_player->player_id);
         free(new_player);
         return NULL;
     }
@@ -76,12 +78,14 @@ MapDataElement playerCopy(MapDataElement player_to_copy) {
     new_player->num_draws = player->num_draws;
     new_player->num_of_games = player->num_of_games;
     new_player->play_time = player->play_time;
+    new_player->level = player->level;
+    new_player->is_move_deferred = false;
+    new_player->version = 0;
     return new_player; 
 }
 
 void playerDestroy(Player player) {
     mapDestroy(player->participances);
-    free(player->player_id);
     free(player);
 }
 
@@ -102,98 +106,173 @@ ChessResult playerDataValidate(Map players, int player_id) {
     return CHESS_SUCCESS;
 }
 
-void setOpponentAsWinner(Map tournaments, int player_id) {
-    Tournament curr_tournament;
+void setOpponentAsWinner(Map tournaments, Map players, int player_id) {
+    Player player = mapGet(players, &player_id);
+    Participance curr_participance;
     Game curr_game;
-    MAP_FOREACH(int*, tournament_iter, tournaments)
+    // only the games of the player are visited, through the games kept in each of his participances
+    MAP_FOREACH_BORROWED(int*, participance_iter, player->participances)
     {
-        curr_tournament = mapGet(tournaments, tournament_iter);
-        if(tournamentCheckIfEnded(curr_tournament)){
-            free(tournament_iter);
-            continue;
-        }
+        curr_participance = mapGetCurrent(player->participances);
+        Tournament curr_tournament = mapGet(tournaments, participance_iter);
+        assert(curr_tournament != NULL);
+        tournamentRemoveParticipant(curr_tournament, player_id);
+        bool is_ended = tournamentCheckIfEnded(curr_tournament);
+        PairSet played_pairs = tournamentGetPlayedPairs(curr_tournament);
         Map games = tournamentGetGames(curr_tournament);
-        MAP_FOREACH(int*, game_iter, games)
+        const int* game_ids = participanceGetGames(curr_participance);
+        int num_of_games = participanceGetNumOfGames(curr_participance);
+        for(int i = 0; i < num_of_games; i++)
         {
-            curr_game = mapGet(games, game_iter);
-            if(gameGetFirstPlayer(curr_game) == player_id)
+            curr_game = mapGet(games, (MapKeyElement)&game_ids[i]);
+            assert(curr_game != NULL);
+            int first_player = gameGetFirstPlayer(curr_game);
+            int second_player = gameGetSecondPlayer(curr_game);
+            pairSetRemove(played_pairs, first_player, second_player);
+            if(is_ended)
+                continue;
+            if(first_player == player_id)
             {
                 if(gameGetWinner(curr_game) != SECOND_PLAYER)
                     gameUpdateWinner(curr_game, SECOND_PLAYER);
             }
-            else if(gameGetSecondPlayer(curr_game) == player_id)
+            else
             {
                 if(gameGetWinner(curr_game) != FIRST_PLAYER)
                     gameUpdateWinner(curr_game, FIRST_PLAYER);
             }
-            free(game_iter);
         }
-        free(tournament_iter);
     }
 }
 
-double playerCalculateAveragePlayTime(Map players, int player_id) {
-    Player player = mapGet(players, &player_id);
-    double total_play_time = player->play_time;
-    int num_of_games = player->num_of_games;
-    return (double)(total_play_time/num_of_games);
+// changes the results of a player while other threads may read them with playerReadResults. the version is odd
+// while the results change. every field is stored whole and after the odd version, and read before the version
+// is read again, so a reader that finds the same even version around them saw either all or none of the change
+static void publishResults(Player player, int wins, int losses, int draws, int num_of_games, double play_time) {
+    unsigned version = player->version;
+    __atomic_store_n(&player->version, version + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&player->num_wins, wins, __ATOMIC_RELEASE);
+    __atomic_store_n(&player->num_losses, losses, __ATOMIC_RELEASE);
+    __atomic_store_n(&player->num_draws, draws, __ATOMIC_RELEASE);
+    __atomic_store_n(&player->num_of_games, num_of_games, __ATOMIC_RELEASE);
+    __atomic_store(&player->play_time, &play_time, __ATOMIC_RELEASE);
+    __atomic_store_n(&player->version, version + 2, __ATOMIC_RELEASE);
 }
 
-static void swap(double**arr,int player1,int player2) {
-    int temp;
-    for(int i = 0; i < NUM_OF_COMPONENTS; i++){
-        temp=arr[player1][i];
-        arr[player1][i]=arr[player2][i];
-        arr[player2][i]=temp;
+void playerReadResults(Player player, PlayerResults* results) {
+    while(true){
+        unsigned version = __atomic_load_n(&player->version, __ATOMIC_ACQUIRE);
+        if(version % 2 == 1)
+            continue;
+        results->wins = __atomic_load_n(&player->num_wins, __ATOMIC_ACQUIRE);
+        results->losses = __atomic_load_n(&player->num_losses, __ATOMIC_ACQUIRE);
+        results->draws = __atomic_load_n(&player->num_draws, __ATOMIC_ACQUIRE);
+        results->num_of_games = __atomic_load_n(&player->num_of_games, __ATOMIC_ACQUIRE);
+        __atomic_load(&player->play_time, &results->play_time, __ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&player->version, __ATOMIC_RELAXED) == version)
+            return;
     }
 }
 
-static void bubbleSort(double** array, int size)
-{
-   for (int i = 0; i < size-1; i++)     
-       for (int j = 0; j < size-i-1; j++)
-           if (array[j][LEVEL] < array[j+1][LEVEL])
-              swap(array, j, j+1);
+double playerCalculateAveragePlayTime(Map players, int player_id) {
+    PlayerResults results;
+    playerReadResults(mapGet(players, &player_id), &results);
+    return (double)(results.play_time/results.num_of_games);
 }
 
-void playerAssignLevel(double **players_array, Map players) {
-    int counter = 0;
-    Player curr_player;
+// calculates the level of a player from his results
+static double calculateLevel(int num_wins, int num_losses, int num_draws, int num_of_games) {
+    double wins = num_wins, losses = num_losses, draws = num_draws, n = num_of_games;
+    return (double)((6*wins-10*losses+2*draws)/n);
+}
 
-    MAP_FOREACH(int*, player_iter, players){
-        curr_player = mapGet(players, player_iter);
-        players_array[counter][LEVEL] = playerCalculateLevel(curr_player);
-        players_array[counter][ID] = *(curr_player->player_id);
-        counter++;
-        free(player_iter);
-    }
-    int size = mapGetSize(players);
-    bubbleSort(players_array, size);
-}
-        
-double playerCalculateLevel(Player player) {
-    double num_wins, num_losses, num_draws, n;
-    num_wins = player->num_wins;
-    num_losses = player->num_losses;
-    num_draws = player->num_draws;
-    n = player->num_of_games;
-    return (double)((6*num_wins-10*num_losses+2*num_draws)/n);
-}
-
-ChessResult printToFile(Map players, double** players_array, FILE* file) {
-    for(int i = 0; i < mapGetSize(players); i++){
-        if(!fprintf(file, "%.0lf %.2lf\n", players_array[i][ID], players_array[i][LEVEL]))
-            return CHESS_SAVE_FAILURE;
-    }
+double playerGetLevel(Player player) {
+    return player->level;
+}
+
+double playerReadLevel(Map players, int player_id) {
+    PlayerResults results;
+    playerReadResults(mapGet(players, &player_id), &results);
+    if(results.num_of_games == 0)
+        return 0;
+    return calculateLevel(results.wins, results.losses, results.draws, results.num_of_games);
+}
+
+// prints a player of the leaderboard to the file given as context
+static bool printLevel(int player_id, double level, void* file) {
+    return fprintf(file, "%d %.2lf\n", player_id, level) >= 0;
+}
+
+// writes the line printLevel prints for a player
+static int formatLevel(char* line, int size, int player_id, double level) {
+    return snprintf(line, size, "%d %.2lf\n", player_id, level);
+}
+
+ChessResult printToFile(Leaderboard leaderboard, FILE* file) {
+    const char* text;
+    size_t size;
+    if(leaderboardExport(leaderboard, formatLevel, &text, &size))
+        return size == 0 || fwrite(text, 1, size, file) == size ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+    // the lines couldn't be kept, so they're printed one by one
+    if(!leaderboardWalk(leaderboard, printLevel, file))
+        return CHESS_SAVE_FAILURE;
+    return CHESS_SUCCESS;
+}
 
+ChessResult printViewToFile(LeaderboardView view, FILE* file) {
+    if(!leaderboardViewWalk(view, printLevel, file))
+        return CHESS_SAVE_FAILURE;
     return CHESS_SUCCESS;
 }
 
-// adds a new player to the map of players in the chess system
-static ChessResult addPlayer(Map players, int id) {
+void playerRemoveFromLeaderboard(Map players, int player_id, Leaderboard leaderboard) {
+    Player player = mapGet(players, &player_id);
+    if(player->num_of_games > 0)
+        leaderboardRemove(leaderboard, player_id, player->level);
+}
+
+int playerGetRank(Map players, int player_id, Leaderboard leaderboard) {
+    Player player = mapGet(players, &player_id);
+    if(player->num_of_games == 0)
+        return UNDEFINED;
+    return leaderboardGetRank(leaderboard, player_id, player->level);
+}
+
+// puts a player that has just played a game at the place of his new level in the leaderboard.
+// a deferred move only remembers the level the player is filed under, until playerFinishDeferredMove.
+// must be called before the results of the player are changed.
+static void moveInLeaderboard(Leaderboard leaderboard, Player player, double new_level, bool defer_move) {
+    if(defer_move){
+        if(!player->is_move_deferred){
+            // a player who played his first game was just inserted at his new level
+            player->filed_level = player->num_of_games > 0 ? player->level : new_level;
+            player->is_move_deferred = true;
+        }
+        return;
+    }
+    if(player->num_of_games > 0)
+        leaderboardMove(leaderboard, player->player_id, player->level, new_level);
+}
+
+bool playerIsMoveDeferred(Player player) {
+    return player->is_move_deferred;
+}
+
+void playerFinishDeferredMove(Map players, int player_id, Leaderboard leaderboard) {
+    Player player = mapGet(players, &player_id);
+    if(player == NULL || !player->is_move_deferred)
+        return;
+    double level = player->level;
+    if(level != player->filed_level)
+        leaderboardMove(leaderboard, player_id, player->filed_level, level);
+    player->is_move_deferred = false;
+}
+
+// adds a new player to the map of players in the chess system. returns NULL if an allocation failed.
+static Player addPlayer(Map players, int id) {
     Player player = playerCreate(id);
     if(player == NULL) {
-        return CHESS_OUT_OF_MEMORY;
+        return NULL;
     }
     player->num_wins = 0;
     player->num_losses = 0;
@@ -201,75 +280,150 @@ static ChessResult addPlayer(Map players, int id) {
     player->num_of_games = 0;
     player->play_time = 0;
 
-    MapResult res_of_put = mapPut(players, &id, player);
-    playerDestroy(player);
+    MapResult res_of_put = mapPutMove(players, &id, player);
     if(res_of_put != MAP_SUCCESS){
-        return CHESS_OUT_OF_MEMORY;
+        playerDestroy(player);
+        return NULL;
     }
-    return CHESS_SUCCESS;
+    return player;
 }
 
-ChessResult updatePlayersData(Map players, int first_player, int second_player, Winner winner, int play_time, int tour_id) {
-    assert(players != NULL);
-    Player player1 = mapGet(players, &first_player);
-    Player player2 = mapGet(players, &second_player);
-
-    player1->num_of_games++;
-    player1->play_time += play_time;
-    player2->num_of_games++;
-    player2->play_time += play_time;
-
-    if(winner == FIRST_PLAYER){
-        player1->num_wins++;
-        player2->num_losses++;
-    }
-    else if(winner == SECOND_PLAYER){
-        player2->num_wins++;
-        player1->num_losses++;
-    }
-    else{
-        player1->num_draws++;
-        player2->num_draws++;
+ChessResult updatePlayersData(Leaderboard leaderboard, Player player1, Participance participance1,
+                              Player player2, Participance participance2,
+                              Winner winner, int play_time, int game_id, bool defer_move) {
+    assert(player1 != NULL && player2 != NULL);
+    // the only allocations are made before anything is changed, so a failure leaves both players as they were
+    if(!participanceReserveGame(participance1) || !participanceReserveGame(participance2))
+        return CHESS_OUT_OF_MEMORY;
+    double new_level1 = calculateLevel(player1->num_wins + (winner == FIRST_PLAYER),
+                                       player1->num_losses + (winner == SECOND_PLAYER),
+                                       player1->num_draws + (winner == DRAW), player1->num_of_games + 1);
+    double new_level2 = calculateLevel(player2->num_wins + (winner == SECOND_PLAYER),
+                                       player2->num_losses + (winner == FIRST_PLAYER),
+                                       player2->num_draws + (winner == DRAW), player2->num_of_games + 1);
+    // players enter the leaderboard with their first game
+    if(player1->num_of_games == 0 && !leaderboardInsert(leaderboard, player1->player_id, new_level1))
+        return CHESS_OUT_OF_MEMORY;
+    if(player2->num_of_games == 0 && !leaderboardInsert(leaderboard, player2->player_id, new_level2)){
+        if(player1->num_of_games == 0)
+            leaderboardRemove(leaderboard, player1->player_id, new_level1);
+        return CHESS_OUT_OF_MEMORY;
     }
+    moveInLeaderboard(leaderboard, player1, new_level1, defer_move);
+    moveInLeaderboard(leaderboard, player2, new_level2, defer_move);
 
-    Map participances1 = playerGetParticipances(player1);
-    participanceRaiseNumOfGames(participances1, tour_id);
-    
-    Map participances2 = playerGetParticipances(player2);
-    participanceRaiseNumOfGames(participances2, tour_id);
+    publishResults(player1, player1->num_wins + (winner == FIRST_PLAYER),
+                   player1->num_losses + (winner == SECOND_PLAYER), player1->num_draws + (winner == DRAW),
+                   player1->num_of_games + 1, player1->play_time + play_time);
+    publishResults(player2, player2->num_wins + (winner == SECOND_PLAYER),
+                   player2->num_losses + (winner == FIRST_PLAYER), player2->num_draws + (winner == DRAW),
+                   player2->num_of_games + 1, player2->play_time + play_time);
+    player1->level = new_level1;
+    player2->level = new_level2;
+
+    participanceRaiseNumOfGames(participance1, game_id);
+    participanceRaiseNumOfGames(participance2, game_id);
 
     if(winner == FIRST_PLAYER)
-        participanceWinnerUpdate(player1->participances, player2->participances, tour_id);
+        participanceWinnerUpdate(participance1, participance2);
     else if(winner == SECOND_PLAYER)
-        participanceWinnerUpdate(player2->participances, player1->participances, tour_id);
+        participanceWinnerUpdate(participance2, participance1);
     else
-        participanceDrawUpdate(player1->participances, player2->participances, tour_id);
+        participanceDrawUpdate(participance1, participance2);
     return CHESS_SUCCESS;
 }
 
+void playerRemoveTournament(Map players, Tournament tournament) {
+    int tournament_id = tournamentGetId(tournament);
+    Map roster = tournamentGetRoster(tournament);
+    MAP_FOREACH_BORROWED(int*, player_iter, roster) {
+        Player player = mapGet(players, player_iter);
+        assert(player != NULL);
+        mapRemove(player->participances, &tournament_id);
+    }
+}
+
 Map playerGetParticipances(Player player) {
     return player->participances; 
 }
 
-// checks if a given player is new in the chess system
-static bool playerCheckIfNew(Map players, int player_id) {
-    if(mapContains(players, &player_id)){
-        return false;
+int playerGetId(Player player) {
+    return player->player_id;
+}
+
+int playerGetWins(Player player) {
+    return player->num_wins;
+}
+
+int playerGetLosses(Player player) {
+    return player->num_losses;
+}
+
+int playerGetDraws(Player player) {
+    return player->num_draws;
+}
+
+int playerGetNumOfGames(Player player) {
+    return player->num_of_games;
+}
+
+double playerGetPlayTime(Player player) {
+    return player->play_time;
+}
+
+ChessResult playerRestore(Map players, Leaderboard leaderboard, int player_id, int wins, int losses, int draws,
+                          int num_of_games, double play_time, int participances_num) {
+    Player player = playerCreate(player_id);
+    if(player == NULL)
+        return CHESS_OUT_OF_MEMORY;
+    player->num_wins = wins;
+    player->num_losses = losses;
+    player->num_draws = draws;
+    player->num_of_games = num_of_games;
+    player->play_time = play_time;
+    if(num_of_games > 0)
+        player->level = calculateLevel(wins, losses, draws, num_of_games);
+    if(mapReserve(player->participances, participances_num) != MAP_SUCCESS ||
+       mapPutMove(players, &player_id, player) != MAP_SUCCESS){
+        playerDestroy(player);
+        return CHESS_OUT_OF_MEMORY;
     }
-    return true;
+    if(num_of_games > 0 && !leaderboardInsert(leaderboard, player_id, player->level)){
+        mapRemove(players, &player_id);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    return CHESS_SUCCESS;
 }
 
-// adds a participance in a given tournament to a given player
-static ChessResult addParticipance(int tournament_id, Player player) {
-    Participance participance = participanceCreate(player->participances, tournament_id);
+// adds a participance in a given tournament to a given player. returns NULL if an allocation failed.
+static Participance addParticipance(Tournament tournament, Player player) {
+    int tournament_id = tournamentGetId(tournament);
+    Participance participance = participanceCreate(tournamentGetParticipancesPool(tournament), tournament_id);
     if(participance == NULL){
-        return CHESS_OUT_OF_MEMORY;
+        return NULL;
     }
-    MapResult res_of_put = mapPut(player->participances, &tournament_id, participance);
-    participanceDestroy(participance);
+    MapResult res_of_put = mapPutMove(player->participances, &tournament_id, participance);
     if(res_of_put != MAP_SUCCESS){
-        return CHESS_OUT_OF_MEMORY;
+        participanceDestroy(participance);
+        return NULL;
+    }
+    if(!tournamentAddParticipant(tournament, player->player_id, participance)){
+        mapRemove(player->participances, &tournament_id);
+        return NULL;
     }
+    return participance;
+}
+
+ChessResult playerRestoreParticipance(Map players, int player_id, Tournament tournament, int wins, int losses,
+                                      int draws, const int* game_ids, int num_of_games) {
+    Player player = mapGet(players, &player_id);
+    assert(player != NULL);
+    Participance participance = addParticipance(tournament, player);
+    if(participance == NULL)
+        return CHESS_OUT_OF_MEMORY;
+    if(!participanceRestore(participance, wins, losses, draws, game_ids, num_of_games))
+        return CHESS_OUT_OF_MEMORY;
+    tournamentUpdateStandings(tournament, player_id);
     return CHESS_SUCCESS;
 }
 
@@ -281,34 +435,29 @@ static bool isMaxGamesExceeded(int num_of_games, int max) {
     return true;
 }
 
-ChessResult playerCheckIfCanPlayInTournament(Map players, int player_id, int tournament_id, int max_games_for_player) {
-    ChessResult res = CHESS_SUCCESS;
-    if (playerCheckIfNew(players, player_id)){
-        res = addPlayer(players, player_id);
-        if (res != CHESS_SUCCESS){
-            return res;
+ChessResult playerCheckIfCanPlayInTournament(Map players, int player_id, Tournament tournament,
+                                             Player* player, Participance* participance) {
+    int tournament_id = tournamentGetId(tournament);
+    // the player and the participance are looked up once, and handed on to updatePlayersData
+    Player found_player = mapGet(players, &player_id);
+    if (found_player == NULL) {
+        found_player = addPlayer(players, player_id);
+        if (found_player == NULL) {
+            return CHESS_OUT_OF_MEMORY;
         }
-        Player player = mapGet(players, &player_id); 
-        res = addParticipance(tournament_id, player);
-        return res;
     }
-
-    else { //if player is already in the players map
-        Player player = mapGet(players, &player_id); 
-        assert(player != NULL);
-
-        if (mapContains(player->participances, &tournament_id)){
-            Participance participance = mapGet(player->participances, &tournament_id);
-            assert(participance != NULL);
-            int num_of_games = participanceGetNumOfGames(participance);
-            if (isMaxGamesExceeded(num_of_games, max_games_for_player) == true){
-                return CHESS_EXCEEDED_GAMES;
-            }
-            return CHESS_SUCCESS;
-        }
-        else {
-            res = addParticipance(tournament_id, player);
-            return res;
+    Participance found_participance = mapGet(found_player->participances, &tournament_id);
+    if (found_participance == NULL) {
+        found_participance = addParticipance(tournament, found_player);
+        if (found_participance == NULL) {
+            return CHESS_OUT_OF_MEMORY;
         }
     }
+    else if (isMaxGamesExceeded(participanceGetNumOfGames(found_participance),
+                                tournamentGetMaxGamesForPlayer(tournament)) == true) {
+        return CHESS_EXCEEDED_GAMES;
+    }
+    *player = found_player;
+    *participance = found_participance;
+    return CHESS_SUCCESS;
 }
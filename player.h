@@ -2,10 +2,20 @@
 #define _PLAYERS_H
 
 #include <stdio.h>
+#include <stdbool.h>
 
 /** Type for representing one player */
 typedef struct player_t* Player;
 
+/** The results of a player in all the tournaments, as read together by playerReadResults */
+typedef struct {
+    int wins;
+    int losses;
+    int draws;
+    int num_of_games;
+    double play_time;
+} PlayerResults;
+
 /**
  * playerCreate: allocates a new player and it's resources.
  * 
@@ -55,31 +65,77 @@ ChessResult playerDataValidate(Map players, int player_id);
 
 /**
  * setOpponentAsWinner: in case of a player that is being removed from a tournament which is still going, sets the other player as the winner of the game.
+ *                      The pairs of the player are also removed from the played pairs of every tournament.
+ *                      The player also stops being counted as a participant of the tournaments.
+ *                      Only the games of the player are visited, so the time depends on his number of games.
  * 
  * @param tournaments - a map of all tournaments in the chess system. 
+ * @param players - a map of all players in the chess system. Must contain the player.
  * @param player_id - the id of the player that is removed and his opponents is set as winner.
  * 
  */
-void setOpponentAsWinner(Map tournaments, int player_id);
+void setOpponentAsWinner(Map tournaments, Map players, int player_id);
 
 /**
  * updatePlayersData: after a game is other, updates the game data for both players. 
  * 
- * @param players - a map of all players in the chess system. 
- * @param fisrt_player - the id of the first player in the game.
- * @param second_player - the id of the second player in the game.
+ * @param leaderboard - the leaderboard of all players, in which both players are moved to their new level.
+ * @param fisrt_player - the first player in the game.
+ * @param first_participance - the participance of the first player in the tournament of the game.
+ * @param second_player - the second player in the game.
+ * @param second_participance - the participance of the second player in the tournament of the game.
  * @param winner - the winner of the game. Could be the fisrt player, the second one or a draw.
  * @param play_time - the total playtime of the game.
- * @param tournament_id - the tournament to which the game belongs.
+ * @param game_id - the id of the game in the tournament, which is added to the games of both players.
+ * @param defer_move - whether moving the players to their new places in the leaderboard is deferred, so a batch
+ *                     of games moves every player once. playerFinishDeferredMove must then be called for both
+ *                     players before the leaderboard or the levels are used. Players are still inserted
+ *                     to the leaderboard with their first game, since that may fail.
  * 
  * @return
- * CHESS_OUT_OF_MEMORY if the creation of a new participance for the player in the tournament faild.
+ * CHESS_OUT_OF_MEMORY if an allocation failed. In that case the data of the players is not changed.
  * CHESS_SUCCESS otherwise.
  * 
  */
-ChessResult updatePlayersData(Map players, int first_player, int second_player, Winner winner, int play_time, int tournament_id);
+ChessResult updatePlayersData(Leaderboard leaderboard, Player first_player, Participance first_participance,
+                              Player second_player, Participance second_participance,
+                              Winner winner, int play_time, int game_id, bool defer_move);
+
+/**
+ * playerFinishDeferredMove: moves a player whose move in the leaderboard was deferred by updatePlayersData
+ *                           to the place of his current level.
+ * 
+ * @param players - a map of all players in the chess system. 
+ * @param player_id - the id of the player. Players that don't exist or have no deferred move are skipped.
+ * @param leaderboard - the leaderboard of all players.
+ * 
+ */
+void playerFinishDeferredMove(Map players, int player_id, Leaderboard leaderboard);
+
+/**
+ * playerIsMoveDeferred: checks if moving a player in the leaderboard was deferred by updatePlayersData,
+ *                       and wasn't finished yet by playerFinishDeferredMove.
+ * 
+ * @param player - the player.
+ * 
+ * @return
+ * true if the move of the player is deferred, false otherwise.
+ * 
+ */
+bool playerIsMoveDeferred(Player player);
 
 
+/**
+ * playerRemoveTournament: removes the participances of all players in a given tournament,
+ *                         which must be done before the tournament and its pool of participances are destroyed.
+ *                         Only the players in the roster of the tournament are visited.
+ * 
+ * @param players - a map of all players in the chess system. 
+ * @param tournament - the tournament that is removed.
+ * 
+ */
+void playerRemoveTournament(Map players, Tournament tournament);
+
 /**
  * playerGetParticipances: gets a map of all the player participances in all the different tournaments and their information.
  * 
@@ -91,32 +147,124 @@ ChessResult updatePlayersData(Map players, int first_player, int second_player,
 Map playerGetParticipances (Player player);
 
 /**
- * playerCalculateLevel: calculate the level of each player in the chess system. 
- *                       player level = 6*(number of his wins) - 10*(number of his losses) +2*(number of his draws)
+ * playerGetId: gets the id of a player.
  * 
- * @param player - a player whose level is calculated.  
+ * @param player - the player whose id is gotten.
  * 
  * @return 
- * the player's level.
+ * the player's id.
  */
-double playerCalculateLevel(Player player);
+int playerGetId(Player player);
 
 /**
- * playerAssignLevel: assign all the players levels in the array given.
+ * playerGetWins: gets the number of games a player won, in all the tournaments.
  * 
- * @param players_array - an array that contains the level of each player in the chess system.
- * @param players - a map of all the players in the cess system.
+ * @param player - the player whose wins are counted.
+ * 
+ * @return 
+ * the player's number of wins.
+ */
+int playerGetWins(Player player);
+
+/**
+ * playerGetLosses: gets the number of games a player lost, in all the tournaments.
+ * 
+ * @param player - the player whose losses are counted.
  * 
+ * @return 
+ * the player's number of losses.
  */
-void playerAssignLevel(double **players_array, Map players);
+int playerGetLosses(Player player);
 
+/**
+ * playerGetDraws: gets the number of games of a player that ended with a draw, in all the tournaments.
+ * 
+ * @param player - the player whose draws are counted.
+ * 
+ * @return 
+ * the player's number of draws.
+ */
+int playerGetDraws(Player player);
+
+/**
+ * playerGetNumOfGames: gets the number of games a player played, in all the tournaments.
+ * 
+ * @param player - the player whose games are counted.
+ * 
+ * @return 
+ * the player's number of games.
+ */
+int playerGetNumOfGames(Player player);
 
+/**
+ * playerGetPlayTime: gets the sum of the times of the games a player played.
+ * 
+ * @param player - the player whose play time is gotten.
+ * 
+ * @return 
+ * the player's total play time.
+ */
+double playerGetPlayTime(Player player);
 
 /**
- * printToFile: prints to a given file the id and the level of each player in the chess system.
+ * playerRestore: adds a player with no participances to the chess system, in the state it was saved by
+ *                a snapshot of the system. The player enters the leaderboard if he played a game.
  * 
- * @param players - a map of all the players in the cess system.
- * @param players_array - an array that contains the level of each player in the chess system.
+ * @param players - a map of all the players in the chess system. Must not contain the player.
+ * @param leaderboard - the leaderboard of all the players in the chess system.
+ * @param player_id - the id of the player.
+ * @param wins - the number of games the player won.
+ * @param losses - the number of games the player lost.
+ * @param draws - the number of games of the player that ended with a draw.
+ * @param num_of_games - the number of games the player played.
+ * @param play_time - the sum of the times of the games the player played.
+ * @param participances_num - the number of participances that are going to be restored for the player.
+ * 
+ * @return 
+ * CHESS_OUT_OF_MEMORY - if an allocation failed. The player isn't added.
+ * CHESS_SUCCESS - otherwise.
+ */
+ChessResult playerRestore(Map players, Leaderboard leaderboard, int player_id, int wins, int losses, int draws,
+                          int num_of_games, double play_time, int participances_num);
+
+/**
+ * playerRestoreParticipance: adds a participance of a restored player in a restored tournament, in the state it
+ *                            was saved by a snapshot of the system, and puts the player in the roster and the
+ *                            standings of the tournament.
+ * 
+ * @param players - a map of all the players in the chess system.
+ * @param player_id - the id of the player. Must be in the map, and not take part in the tournament yet.
+ * @param tournament - the tournament. The participance is allocated from its pool.
+ * @param wins - the number of games the player won in the tournament.
+ * @param losses - the number of games the player lost in the tournament.
+ * @param draws - the number of games of the player in the tournament that ended with a draw.
+ * @param game_ids - the ids of the games of the player in the tournament, in the order they were added.
+ * @param num_of_games - the number of game ids.
+ * 
+ * @return 
+ * CHESS_OUT_OF_MEMORY - if an allocation failed. The player may be left in the tournament with no games.
+ * CHESS_SUCCESS - otherwise.
+ */
+ChessResult playerRestoreParticipance(Map players, int player_id, Tournament tournament, int wins, int losses,
+                                      int draws, const int* game_ids, int num_of_games);
+
+/**
+ * playerGetLevel: gives the level of a player, which is kept up to date with his results.
+ *                 player level = (6*(number of his wins) - 10*(number of his losses) + 2*(number of his draws))
+ *                                / (number of his games)
+ *
+ * @param player - the player whose level is given.
+ *
+ * @return
+ * the player's level, or 0 if he didn't play yet.
+ */
+double playerGetLevel(Player player);
+
+/**
+ * printToFile: prints to a given file the id and the level of each player in the chess system that played a game,
+ *              from the highest level to the lowest, and players with the same level from the lowest id.
+ * 
+ * @param leaderboard - the leaderboard of all the players in the chess system.
  * @param file - a file to which the data is printed
  * 
  * @return
@@ -124,10 +272,71 @@ void playerAssignLevel(double **players_array, Map players);
  * CHESS_SUCCESS otherwise.
  * 
  */
-ChessResult printToFile(Map players, double** players_array, FILE* file);
+ChessResult printToFile(Leaderboard leaderboard, FILE* file);
+
+/**
+ * printViewToFile: prints the players of a view of the leaderboard to a given file, like printToFile.
+ *
+ * @param view - a view of the leaderboard of the chess system.
+ * @param file - a file to which the data is printed
+ *
+ * @return
+ * CHESS_SAVE_FAILURE if failed to save the data printed to it.
+ * CHESS_SUCCESS otherwise.
+ *
+ */
+ChessResult printViewToFile(LeaderboardView view, FILE* file);
+
+/**
+ * playerRemoveFromLeaderboard: removes a player that is removed from the chess system from the leaderboard.
+ * 
+ * @param players - a map of all the players in the cess system. Must contain the player.
+ * @param player_id - the id of the player.
+ * @param leaderboard - the leaderboard of all the players in the chess system.
+ * 
+ */
+void playerRemoveFromLeaderboard(Map players, int player_id, Leaderboard leaderboard);
+
+/**
+ * playerGetRank: gives the position of a player in the leaderboard.
+ * 
+ * @param players - a map of all the players in the cess system. Must contain the player.
+ * @param player_id - the id of the player.
+ * @param leaderboard - the leaderboard of all the players in the chess system.
+ * 
+ * @return
+ * -1 if the player didn't play any game, so he has no level,
+ * or the number of players ranked before him otherwise.
+ * 
+ */
+int playerGetRank(Map players, int player_id, Leaderboard leaderboard);
+
+/**
+ * playerReadResults: reads the results of a player at once, while updatePlayersData may be changing them
+ *                    from another thread. The reader doesn't lock anything and never holds up the writer:
+ *                    it reads again if the results changed while it read them.
+ * 
+ * @param player - the player. Must not be removed while it's read.
+ * @param results - the results to write.
+ * 
+ */
+void playerReadResults(Player player, PlayerResults* results);
+
+/**
+ * playerReadLevel: gives the level of a player from his current results, read like playerReadResults.
+ * 
+ * @param players - a map of all the players in the chess system. Must contain the player.
+ * @param player_id - the id of the player.
+ * 
+ * @return
+ * the level of the player, or 0 if he didn't play any game.
+ * 
+ */
+double playerReadLevel(Map players, int player_id);
 
 /**
  * playerCalculateAveragePlayTime: calculates the average play time of a given player by dividing his total play time in his numbers of games.
+ *                                 The results of the player are read like playerReadResults.
  * 
  * @param players - a map of all the players in the cess system.
  * @param player_id - the id of the player.
@@ -140,19 +349,22 @@ double playerCalculateAveragePlayTime(Map players, int player_id);
 
 /**
  *  playerCheckIfCanPlayInTournament: checks if the player can play in a given tournament, meaning he hasen't exceed the max num of games yet,
- *                                    
+ *                                    and adds the player and his participance in the tournament if they are new.
  * 
  * @param players - a map of all the players in the cess system.
  * @param player_id - the id of the player.
- * @param tournament_id - the id of the tournament.
- * @param max_games_for_player - the max number of games a player can take part in in this tournamant.
+ * @param tournament - the tournament. New participances are allocated from its pool.
+ * @param player - pointer to write the player to, when the result is CHESS_SUCCESS.
+ * @param participance - pointer to write the participance of the player in the tournament to,
+ *                       when the result is CHESS_SUCCESS.
  * 
  * @return
  * CHESS_OUT_OF_MEMORY - if it's a new player and his allocation failed.
  * CHESS_EXCEEDED_GAMES - if it's a old player that has already exceeded the max num of games for this tournament.
  * CHESS_SUCCESS - otherwise, meaning the player can play in the tournament.
  */
-ChessResult playerCheckIfCanPlayInTournament(Map players, int player_id, int tournament_id, int max_games_for_player);
+ChessResult playerCheckIfCanPlayInTournament(Map players, int player_id, Tournament tournament,
+                                             Player* player, Participance* participance);
 
 #endif //_PLAYERS_H
 
@@ -0,0 +1,129 @@
+#include "pool.h"
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#define FIRST_SLAB_OBJECTS 16
+#define MAX_SLAB_OBJECTS 1024
+#define SLAB_GROWTH_FACTOR 2
+
+// the strictest alignment an object of the pool may need
+typedef union {
+    void* pointer;
+    double floating;
+    long integer;
+} Align;
+
+// a slab is this header followed by the memory of its objects
+typedef union slab_t {
+    union slab_t* next;
+    Align align;
+} Slab;
+
+// a freed object holds the link to the next freed object
+typedef struct free_object_t {
+    struct free_object_t* next;
+} FreeObject;
+
+struct pool_t {
+    size_t object_size;
+    int slab_objects;
+    Slab* slabs;
+    char* next_object;
+    char* slab_end;
+    FreeObject* free_objects;
+    int free_num;
+};
+
+Pool poolCreate(int object_size) {
+    assert(object_size > 0);
+    Pool pool = malloc(sizeof(*pool));
+    if (pool == NULL) {
+        return NULL;
+    }
+    // every object must be able to hold a free list link and keep the next object aligned
+    size_t size = (object_size < (int)sizeof(FreeObject)) ? sizeof(FreeObject) : (size_t)object_size;
+    pool->object_size = (size + sizeof(Align) - 1) / sizeof(Align) * sizeof(Align);
+    pool->slab_objects = FIRST_SLAB_OBJECTS;
+    pool->slabs = NULL;
+    pool->next_object = NULL;
+    pool->slab_end = NULL;
+    pool->free_objects = NULL;
+    pool->free_num = 0;
+    return pool;
+}
+
+void poolDestroy(Pool pool) {
+    if (pool == NULL) {
+        return;
+    }
+    while (pool->slabs != NULL) {
+        Slab* next = pool->slabs->next;
+        free(pool->slabs);
+        pool->slabs = next;
+    }
+    free(pool);
+}
+
+// allocates a new slab of a given number of objects, which objects are allocated from next
+static bool addSlab(Pool pool, int objects) {
+    Slab* slab = malloc(sizeof(Slab) + pool->object_size*objects);
+    if (slab == NULL) {
+        return false;
+    }
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->next_object = (char*)(slab + 1);
+    pool->slab_end = pool->next_object + pool->object_size*objects;
+    return true;
+}
+
+void* poolAlloc(Pool pool) {
+    if (pool->free_objects != NULL) {
+        FreeObject* object = pool->free_objects;
+        pool->free_objects = object->next;
+        pool->free_num--;
+        return object;
+    }
+    // each slab is twice as big as the one before, up to MAX_SLAB_OBJECTS objects
+    if (pool->next_object == pool->slab_end) {
+        if (!addSlab(pool, pool->slab_objects)) {
+            return NULL;
+        }
+        if (pool->slab_objects < MAX_SLAB_OBJECTS) {
+            pool->slab_objects *= SLAB_GROWTH_FACTOR;
+        }
+    }
+    void* object = pool->next_object;
+    pool->next_object += pool->object_size;
+    return object;
+}
+
+void poolFree(Pool pool, void* object) {
+    if (object == NULL) {
+        return;
+    }
+    FreeObject* free_object = object;
+    free_object->next = pool->free_objects;
+    pool->free_objects = free_object;
+    pool->free_num++;
+}
+
+bool poolReserve(Pool pool, int count) {
+    int available = pool->free_num + (int)((pool->slab_end - pool->next_object) / pool->object_size);
+    if (available >= count) {
+        return true;
+    }
+    // the rest of the current slab goes to the free list, and the new slab holds exactly the missing objects
+    char* rest = pool->next_object;
+    char* rest_end = pool->slab_end;
+    if (!addSlab(pool, count - available)) {
+        return false;
+    }
+    for (; rest != rest_end; rest += pool->object_size) {
+        poolFree(pool, rest);
+    }
+    return true;
+}
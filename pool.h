@@ -0,0 +1,60 @@
+#ifndef _POOL_H
+#define _POOL_H
+
+#include <stdbool.h>
+
+/** Type for a pool of equally sized objects that are allocated in slabs and freed together */
+typedef struct pool_t *Pool;
+
+
+/**
+ * poolCreate: allocates a new empty pool. Memory for the objects is allocated later, a slab at a time.
+ *
+ * @param object_size - the size in bytes of every object allocated from the pool. Must be positive.
+ *
+ * @return NULL if the allocation failed, or the new pool otherwise.
+ *
+ */
+Pool poolCreate(int object_size);
+
+/**
+ * poolDestroy: frees the pool together with every object that was allocated from it, at once.
+ *              Objects of the pool must not be used afterwards, even if they were never given to poolFree.
+ *
+ * @param pool - the pool to destroy. May be NULL.
+ *
+ */
+void poolDestroy(Pool pool);
+
+/**
+ * poolAlloc: allocates one object from the pool. Objects freed with poolFree are reused first.
+ *
+ * @param pool - the pool to allocate from. Must be non-NULL.
+ *
+ * @return NULL if a new slab was needed and its allocation failed, or the uninitialized object otherwise.
+ *
+ */
+void* poolAlloc(Pool pool);
+
+/**
+ * poolFree: returns an object to the pool it was allocated from, so the next poolAlloc can reuse it.
+ *
+ * @param pool - the pool the object was allocated from.
+ * @param object - the object to return. May be NULL.
+ *
+ */
+void poolFree(Pool pool, void* object);
+
+/**
+ * poolReserve: makes sure the next count calls of poolAlloc succeed, without poolFree calls in between.
+ *              Allocates at most one slab, of the objects that are missing.
+ *
+ * @param pool - the pool to reserve objects in. Must be non-NULL.
+ * @param count - the number of objects to reserve.
+ *
+ * @return false if the slab couldn't be allocated, and nothing is reserved, or true otherwise.
+ *
+ */
+bool poolReserve(Pool pool, int count);
+
+#endif //_POOL_H
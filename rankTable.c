@@ -0,0 +1,319 @@
+#include "rankTable.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+#define UNDEFINED -1
+#define NUM_OF_COLUMNS 5
+#define INITIAL_CAPACITY 16
+#define MAX_KEY_BITS 63
+
+struct rank_table_t {
+    int* buffer;
+    int capacity;
+    int size;
+    int* ids;
+    int* wins;
+    int* losses;
+    int* draws;
+    int* ranks;
+    // bounds of the values ever put in the table, which decide how the keys are packed
+    int max_id;
+    int max_wins;
+    int max_losses;
+    int max_rank;
+};
+
+// the layout of the key of a row: rank, then losses (inverted), then wins, then id (inverted) in the lowest bits,
+// so that the best row has the largest key
+typedef struct {
+    int rank_shift;
+    int losses_shift;
+    int wins_shift;
+    int max_losses;
+    int max_id;
+} KeyLayout;
+
+// points the columns to their places in a buffer of a given capacity
+static void setColumns(RankTable table, int* buffer, int capacity) {
+    table->buffer = buffer;
+    table->capacity = capacity;
+    table->ids = buffer;
+    table->wins = table->ids + capacity;
+    table->losses = table->wins + capacity;
+    table->draws = table->losses + capacity;
+    table->ranks = table->draws + capacity;
+}
+
+// copies the rows of a table to a buffer of a given capacity, and moves the table to it
+static void moveToBuffer(RankTable table, int* buffer, int capacity, RankTable source) {
+    int* columns[NUM_OF_COLUMNS] = { source->ids, source->wins, source->losses, source->draws, source->ranks };
+    for (int i = 0; i < NUM_OF_COLUMNS && source->size > 0; i++) {
+        memcpy(buffer + i * capacity, columns[i], sizeof(int) * source->size);
+    }
+    setColumns(table, buffer, capacity);
+}
+
+RankTable rankTableCreate() {
+    RankTable table = malloc(sizeof(*table));
+    if (table == NULL) {
+        return NULL;
+    }
+    table->buffer = NULL;
+    table->capacity = 0;
+    table->ids = table->wins = table->losses = table->draws = table->ranks = NULL;
+    table->size = 0;
+    table->max_id = 0;
+    table->max_wins = 0;
+    table->max_losses = 0;
+    table->max_rank = 0;
+    return table;
+}
+
+RankTable rankTableCopy(RankTable table) {
+    RankTable copy = rankTableCreate();
+    if (copy == NULL) {
+        return NULL;
+    }
+    if (table->capacity > 0) {
+        int* buffer = malloc(sizeof(*buffer) * NUM_OF_COLUMNS * table->capacity);
+        if (buffer == NULL) {
+            free(copy);
+            return NULL;
+        }
+        moveToBuffer(copy, buffer, table->capacity, table);
+    }
+    copy->size = table->size;
+    copy->max_id = table->max_id;
+    copy->max_wins = table->max_wins;
+    copy->max_losses = table->max_losses;
+    copy->max_rank = table->max_rank;
+    return copy;
+}
+
+void rankTableDestroy(RankTable table) {
+    if (table == NULL) {
+        return;
+    }
+    free(table->buffer);
+    free(table);
+}
+
+bool rankTableReserve(RankTable table, int rows) {
+    if (rows <= table->capacity) {
+        return true;
+    }
+    int capacity = table->capacity == 0 ? INITIAL_CAPACITY : 2 * table->capacity;
+    if (capacity < rows) {
+        capacity = rows;
+    }
+    int* buffer = malloc(sizeof(*buffer) * NUM_OF_COLUMNS * capacity);
+    if (buffer == NULL) {
+        return false;
+    }
+    int* old_buffer = table->buffer;
+    moveToBuffer(table, buffer, capacity, table);
+    free(old_buffer);
+    return true;
+}
+
+int rankTableAdd(RankTable table, int player_id) {
+    assert(table->size < table->capacity && player_id > 0);
+    int row = table->size;
+    table->ids[row] = player_id;
+    table->wins[row] = 0;
+    table->losses[row] = 0;
+    table->draws[row] = 0;
+    table->ranks[row] = 0;
+    table->size++;
+    if (player_id > table->max_id) {
+        table->max_id = player_id;
+    }
+    return row;
+}
+
+void rankTableUpdate(RankTable table, int row, int wins, int losses, int draws) {
+    assert(row >= 0 && row < table->size);
+    table->wins[row] = wins;
+    table->losses[row] = losses;
+    table->draws[row] = draws;
+    table->ranks[row] = 2 * wins + draws;
+    if (wins > table->max_wins) {
+        table->max_wins = wins;
+    }
+    if (losses > table->max_losses) {
+        table->max_losses = losses;
+    }
+    if (table->ranks[row] > table->max_rank) {
+        table->max_rank = table->ranks[row];
+    }
+}
+
+int rankTableRemove(RankTable table, int row) {
+    assert(row >= 0 && row < table->size);
+    int last = table->size - 1;
+    table->size--;
+    if (row == last) {
+        return UNDEFINED;
+    }
+    table->ids[row] = table->ids[last];
+    table->wins[row] = table->wins[last];
+    table->losses[row] = table->losses[last];
+    table->draws[row] = table->draws[last];
+    table->ranks[row] = table->ranks[last];
+    return table->ids[row];
+}
+
+int rankTableGetSize(RankTable table) {
+    return table->size;
+}
+
+// checks if the player at one row should win the tournament rather than the player at another row
+static bool isBetter(RankTable table, int row, int other_row) {
+    if (table->ranks[row] != table->ranks[other_row]) {
+        return table->ranks[row] > table->ranks[other_row];
+    }
+    if (table->losses[row] != table->losses[other_row]) {
+        return table->losses[row] < table->losses[other_row];
+    }
+    if (table->wins[row] != table->wins[other_row]) {
+        return table->wins[row] > table->wins[other_row];
+    }
+    return table->ids[row] < table->ids[other_row];
+}
+
+// the criteria are compared one by one, for tables whose keys don't fit in 63 bits
+static int getBestByCriteria(RankTable table) {
+    int best_row = 0;
+    for (int row = 1; row < table->size; row++) {
+        if (isBetter(table, row, best_row)) {
+            best_row = row;
+        }
+    }
+    return table->ids[best_row];
+}
+
+// the number of bits needed to hold values from 0 to a given value
+static int bitsFor(int max_value) {
+    int bits = 0;
+    while (bits < 32 && ((int64_t)1 << bits) <= max_value) {
+        bits++;
+    }
+    return bits;
+}
+
+// sets the layout of the keys of the table. returns false if they don't fit in 63 bits.
+static bool setKeyLayout(RankTable table, KeyLayout* layout) {
+    int id_bits = bitsFor(table->max_id);
+    int wins_bits = bitsFor(table->max_wins);
+    int losses_bits = bitsFor(table->max_losses);
+    int rank_bits = bitsFor(table->max_rank);
+    if (id_bits + wins_bits + losses_bits + rank_bits > MAX_KEY_BITS) {
+        return false;
+    }
+    layout->wins_shift = id_bits;
+    layout->losses_shift = layout->wins_shift + wins_bits;
+    layout->rank_shift = layout->losses_shift + losses_bits;
+    layout->max_losses = table->max_losses;
+    layout->max_id = table->max_id;
+    return true;
+}
+
+static int64_t makeKey(RankTable table, const KeyLayout* layout, int row) {
+    return ((int64_t)table->ranks[row] << layout->rank_shift) |
+           ((int64_t)(layout->max_losses - table->losses[row]) << layout->losses_shift) |
+           ((int64_t)table->wins[row] << layout->wins_shift) |
+           (int64_t)(layout->max_id - table->ids[row]);
+}
+
+#if defined(__AVX2__)
+// the largest key of the rows before a given row, four rows at a time
+static int64_t getMaxKeyVectorized(RankTable table, const KeyLayout* layout, int end) {
+    __m128i rank_shift = _mm_cvtsi32_si128(layout->rank_shift);
+    __m128i losses_shift = _mm_cvtsi32_si128(layout->losses_shift);
+    __m128i wins_shift = _mm_cvtsi32_si128(layout->wins_shift);
+    __m128i max_losses = _mm_set1_epi32(layout->max_losses);
+    __m128i max_id = _mm_set1_epi32(layout->max_id);
+    __m256i best = _mm256_set1_epi64x(-1);
+    for (int row = 0; row < end; row += 4) {
+        __m256i ranks = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(table->ranks + row)));
+        __m256i losses = _mm256_cvtepu32_epi64(
+            _mm_sub_epi32(max_losses, _mm_loadu_si128((const __m128i*)(table->losses + row))));
+        __m256i wins = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(table->wins + row)));
+        __m256i ids = _mm256_cvtepu32_epi64(
+            _mm_sub_epi32(max_id, _mm_loadu_si128((const __m128i*)(table->ids + row))));
+        __m256i keys = _mm256_or_si256(
+            _mm256_or_si256(_mm256_sll_epi64(ranks, rank_shift), _mm256_sll_epi64(losses, losses_shift)),
+            _mm256_or_si256(_mm256_sll_epi64(wins, wins_shift), ids));
+        best = _mm256_blendv_epi8(best, keys, _mm256_cmpgt_epi64(keys, best));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, best);
+    int64_t max_key = lanes[0];
+    for (int i = 1; i < 4; i++) {
+        max_key = lanes[i] > max_key ? lanes[i] : max_key;
+    }
+    return max_key;
+}
+#define VECTOR_ROWS 4
+#elif defined(__SSE4_2__)
+// the largest key of the rows before a given row, two rows at a time
+static int64_t getMaxKeyVectorized(RankTable table, const KeyLayout* layout, int end) {
+    __m128i rank_shift = _mm_cvtsi32_si128(layout->rank_shift);
+    __m128i losses_shift = _mm_cvtsi32_si128(layout->losses_shift);
+    __m128i wins_shift = _mm_cvtsi32_si128(layout->wins_shift);
+    __m128i max_losses = _mm_set1_epi32(layout->max_losses);
+    __m128i max_id = _mm_set1_epi32(layout->max_id);
+    __m128i best = _mm_set1_epi64x(-1);
+    for (int row = 0; row < end; row += 2) {
+        __m128i ranks = _mm_cvtepu32_epi64(_mm_loadl_epi64((const __m128i*)(table->ranks + row)));
+        __m128i losses = _mm_cvtepu32_epi64(
+            _mm_sub_epi32(max_losses, _mm_loadl_epi64((const __m128i*)(table->losses + row))));
+        __m128i wins = _mm_cvtepu32_epi64(_mm_loadl_epi64((const __m128i*)(table->wins + row)));
+        __m128i ids = _mm_cvtepu32_epi64(
+            _mm_sub_epi32(max_id, _mm_loadl_epi64((const __m128i*)(table->ids + row))));
+        __m128i keys = _mm_or_si128(
+            _mm_or_si128(_mm_sll_epi64(ranks, rank_shift), _mm_sll_epi64(losses, losses_shift)),
+            _mm_or_si128(_mm_sll_epi64(wins, wins_shift), ids));
+        best = _mm_blendv_epi8(best, keys, _mm_cmpgt_epi64(keys, best));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, best);
+    return lanes[1] > lanes[0] ? lanes[1] : lanes[0];
+}
+#define VECTOR_ROWS 2
+#else
+#define VECTOR_ROWS 1
+#endif
+
+int rankTableGetBest(RankTable table) {
+    if (table->size == 0) {
+        return UNDEFINED;
+    }
+    KeyLayout layout;
+    if (!setKeyLayout(table, &layout)) {
+        return getBestByCriteria(table);
+    }
+    // every key is different because the ids are, so the largest key belongs to a single row
+    int vector_end = 0;
+    int64_t max_key = -1;
+#if VECTOR_ROWS > 1
+    vector_end = table->size - table->size % VECTOR_ROWS;
+    if (vector_end > 0) {
+        max_key = getMaxKeyVectorized(table, &layout, vector_end);
+    }
+#endif
+    for (int row = vector_end; row < table->size; row++) {
+        int64_t key = makeKey(table, &layout, row);
+        max_key = key > max_key ? key : max_key;
+    }
+    int64_t id_mask = ((int64_t)1 << layout.wins_shift) - 1;
+    return layout.max_id - (int)(max_key & id_mask);
+}
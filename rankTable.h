@@ -0,0 +1,113 @@
+#ifndef _RANK_TABLE_H
+#define _RANK_TABLE_H
+
+#include <stdbool.h>
+
+/**
+ * Type for the results of the players of a tournament, used to choose its winner.
+ * The ids, wins, losses, draws and ranks are kept in separate columns of a single buffer, a row per player,
+ * so the winner is chosen by one pass over contiguous memory.
+ */
+typedef struct rank_table_t *RankTable;
+
+
+/**
+ * rankTableCreate: allocates a new empty table. Memory for the rows is allocated by rankTableReserve.
+ *
+ * @return NULL if the allocation failed, or the new table otherwise.
+ *
+ */
+RankTable rankTableCreate();
+
+/**
+ * rankTableCopy: duplicate a given table with all its rows, which keep their places.
+ *
+ * @param table - the table that is copied. Must be non-NULL.
+ *
+ * @return NULL if the allocation failed, or the new table otherwise.
+ *
+ */
+RankTable rankTableCopy(RankTable table);
+
+/**
+ * rankTableDestroy: frees a table and its buffer.
+ *
+ * @param table - the table to destroy. May be NULL.
+ *
+ */
+void rankTableDestroy(RankTable table);
+
+/**
+ * rankTableReserve: makes room for a given number of rows in the table, keeping the rows it already has.
+ *                   The buffer grows by doubling, so it is only reallocated once in a while.
+ *
+ * @param table - the table to prepare.
+ * @param rows - the total number of rows the table should be able to hold.
+ *
+ * @return false if the allocation failed, or true otherwise.
+ *
+ */
+bool rankTableReserve(RankTable table, int rows);
+
+/**
+ * rankTableAdd: adds a row for a player with no results to the end of the table.
+ *               There must be room for the row, see rankTableReserve.
+ *
+ * @param table - the table to add the player to.
+ * @param player_id - the id of the player. Must be positive.
+ *
+ * @return the row of the player.
+ *
+ */
+int rankTableAdd(RankTable table, int player_id);
+
+/**
+ * rankTableUpdate: sets the results of the player at a given row. Their rank is 2 * wins + draws.
+ *
+ * @param table - the table the player is in.
+ * @param row - the row of the player.
+ * @param wins - the number of games the player won.
+ * @param losses - the number of games the player lost.
+ * @param draws - the number of games that ended with a draw.
+ *
+ */
+void rankTableUpdate(RankTable table, int row, int wins, int losses, int draws);
+
+/**
+ * rankTableRemove: removes the player at a given row. The last row of the table is moved to its place.
+ *
+ * @param table - the table the player is in.
+ * @param row - the row of the player.
+ *
+ * @return -1 if the removed row was the last one, or the id of the player that was moved to the row otherwise.
+ *
+ */
+int rankTableRemove(RankTable table, int row);
+
+/**
+ * rankTableGetSize: gives the number of rows in the table.
+ *
+ * @param table - the table that is checked.
+ *
+ * @return the number of rows in the table.
+ *
+ */
+int rankTableGetSize(RankTable table);
+
+/**
+ * rankTableGetBest: gives the player with the highest rank in the table.
+ *                   If two players have the same rank, the player with least losses is chosen,
+ *                   then the player with the most wins, and then the player with the smaller id.
+ *                   The four criteria are packed into a single 64 bit key for every row, and the keys are
+ *                   compared with AVX2 or SSE4.2 instructions when the code is compiled for them
+ *                   (e.g. with -mavx2). When the values are too large to be packed in 63 bits,
+ *                   the criteria are compared one by one.
+ *
+ * @param table - the table that is checked.
+ *
+ * @return -1 if the table is empty, or the id of the best player otherwise.
+ *
+ */
+int rankTableGetBest(RankTable table);
+
+#endif //_RANK_TABLE_H
@@ -0,0 +1,456 @@
+#include "chessSystem.h"
+#include "map.h"
+#include "mapExtensions.h"
+#include "pool.h"
+#include "pairSet.h"
+#include "leaderboard.h"
+#include "rankTable.h"
+#include "parallel.h"
+#include "tournament.h"
+#include "game.h"
+#include "player.h"
+#include "participance.h"
+#include "checksum.h"
+#include "snapshot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SNAPSHOT_MAGIC "CHESSNAP"
+#define MAGIC_SIZE 8
+#define SNAPSHOT_VERSION 1
+#define BYTE_ORDER_MARK UINT32_C(0x01020304)
+
+// the layout of a snapshot is the header, and then the arrays of records in the order of its counts.
+// records are laid out so no padding is needed, and the arrays with 8 byte fields come first.
+typedef struct {
+    char magic[MAGIC_SIZE];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t checksum; // of everything after the header
+    int32_t tournaments_num;
+    int32_t games_num;
+    int32_t players_num;
+    int32_t participances_num;
+    int32_t game_ids_num;
+    int32_t locations_size;
+} SnapshotHeader;
+
+// followed by games_num games, with the ids 1 to games_num
+typedef struct {
+    double total_play_time;
+    int32_t id;
+    int32_t max_games_for_player;
+    int32_t winner_id;
+    int32_t longest_play_time;
+    int32_t is_ended;
+    int32_t games_num;
+    int32_t participants_num;
+    int32_t location_offset; // of a null terminated string in the locations
+} TournamentRecord;
+
+typedef struct {
+    int32_t first_player;
+    int32_t second_player;
+    int32_t winner;
+    int32_t play_time;
+} GameRecord;
+
+// followed by participances_num participances
+typedef struct {
+    double play_time;
+    int32_t id;
+    int32_t wins;
+    int32_t losses;
+    int32_t draws;
+    int32_t num_of_games;
+    int32_t participances_num;
+} PlayerRecord;
+
+// followed by num_of_games game ids
+typedef struct {
+    int32_t tournament_id;
+    int32_t wins;
+    int32_t losses;
+    int32_t draws;
+    int32_t num_of_games;
+} ParticipanceRecord;
+
+// the arrays of a snapshot that is read
+typedef struct {
+    const SnapshotHeader* header;
+    const TournamentRecord* tournaments;
+    const GameRecord* games;
+    const PlayerRecord* players;
+    const ParticipanceRecord* participances;
+    const int32_t* game_ids;
+    const char* locations;
+    int* first_games; // the index of the first game of every tournament in the games
+} Sections;
+
+typedef struct {
+    FILE* file;
+    Checksum checksum;
+    bool is_ok;
+} Writer;
+
+static void writeBytes(Writer* writer, const void* data, size_t size) {
+    if (!writer->is_ok || size == 0) {
+        return;
+    }
+    checksumAdd(&writer->checksum, data, size);
+    writer->is_ok = fwrite(data, 1, size, writer->file) == size;
+}
+
+static void writeTournaments(Writer* writer, Map tournaments, SnapshotHeader* header) {
+    MAP_FOREACH_BORROWED(int*, tournament_iter, tournaments) {
+        Tournament tournament = mapGetCurrent(tournaments);
+        TournamentRecord record;
+        record.total_play_time = tournamentGetTotalPlayTime(tournament);
+        record.id = tournamentGetId(tournament);
+        record.max_games_for_player = tournamentGetMaxGamesForPlayer(tournament);
+        record.winner_id = tournamentGetWinnerId(tournament);
+        record.longest_play_time = tournamentGetLongestPlayTime(tournament);
+        record.is_ended = tournamentCheckIfEnded(tournament);
+        record.games_num = mapGetSize(tournamentGetGames(tournament));
+        record.participants_num = mapGetSize(tournamentGetRoster(tournament));
+        record.location_offset = header->locations_size;
+        writeBytes(writer, &record, sizeof(record));
+        header->tournaments_num++;
+        header->games_num += record.games_num;
+        header->locations_size += strlen(tournamentGetLocation(tournament)) + 1;
+    }
+}
+
+static void writeGames(Writer* writer, Map tournaments) {
+    MAP_FOREACH_BORROWED(int*, tournament_iter, tournaments) {
+        Map games = tournamentGetGames(mapGetCurrent(tournaments));
+        MAP_FOREACH_BORROWED(int*, game_iter, games) {
+            Game game = mapGetCurrent(games);
+            GameRecord record;
+            record.first_player = gameGetFirstPlayer(game);
+            record.second_player = gameGetSecondPlayer(game);
+            record.winner = gameGetWinner(game);
+            record.play_time = gameGetPlayTime(game);
+            writeBytes(writer, &record, sizeof(record));
+        }
+    }
+}
+
+static void writePlayers(Writer* writer, Map players, SnapshotHeader* header) {
+    MAP_FOREACH_BORROWED(int*, player_iter, players) {
+        Player player = mapGetCurrent(players);
+        PlayerRecord record;
+        record.play_time = playerGetPlayTime(player);
+        record.id = playerGetId(player);
+        record.wins = playerGetWins(player);
+        record.losses = playerGetLosses(player);
+        record.draws = playerGetDraws(player);
+        record.num_of_games = playerGetNumOfGames(player);
+        record.participances_num = mapGetSize(playerGetParticipances(player));
+        writeBytes(writer, &record, sizeof(record));
+        header->players_num++;
+        header->participances_num += record.participances_num;
+    }
+}
+
+static void writeParticipances(Writer* writer, Map players, SnapshotHeader* header) {
+    MAP_FOREACH_BORROWED(int*, player_iter, players) {
+        Map participances = playerGetParticipances(mapGetCurrent(players));
+        MAP_FOREACH_BORROWED(int*, participance_iter, participances) {
+            Participance participance = mapGetCurrent(participances);
+            ParticipanceRecord record;
+            record.tournament_id = participanceGetId(participance);
+            record.wins = participanceGetWins(participance);
+            record.losses = participanceGetLosses(participance);
+            record.draws = participanceGetDraws(participance);
+            record.num_of_games = participanceGetNumOfGames(participance);
+            writeBytes(writer, &record, sizeof(record));
+            header->game_ids_num += record.num_of_games;
+        }
+    }
+}
+
+static void writeGameIds(Writer* writer, Map players) {
+    MAP_FOREACH_BORROWED(int*, player_iter, players) {
+        Map participances = playerGetParticipances(mapGetCurrent(players));
+        MAP_FOREACH_BORROWED(int*, participance_iter, participances) {
+            Participance participance = mapGetCurrent(participances);
+            writeBytes(writer, participanceGetGames(participance),
+                       sizeof(int32_t) * participanceGetNumOfGames(participance));
+        }
+    }
+}
+
+static void writeLocations(Writer* writer, Map tournaments) {
+    MAP_FOREACH_BORROWED(int*, tournament_iter, tournaments) {
+        const char* location = tournamentGetLocation(mapGetCurrent(tournaments));
+        writeBytes(writer, location, strlen(location) + 1);
+    }
+}
+
+ChessResult snapshotWrite(FILE* file, Map tournaments, Map players) {
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    // a header that can't pass as valid holds the place of the real one until it's known
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        return CHESS_SAVE_FAILURE;
+    }
+    Writer writer;
+    writer.file = file;
+    writer.is_ok = true;
+    checksumStart(&writer.checksum);
+    writeTournaments(&writer, tournaments, &header);
+    writeGames(&writer, tournaments);
+    writePlayers(&writer, players, &header);
+    writeParticipances(&writer, players, &header);
+    writeGameIds(&writer, players);
+    writeLocations(&writer, tournaments);
+    if (!writer.is_ok) {
+        return CHESS_SAVE_FAILURE;
+    }
+    memcpy(header.magic, SNAPSHOT_MAGIC, MAGIC_SIZE);
+    header.version = SNAPSHOT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.checksum = checksumEnd(&writer.checksum);
+    if (fseek(file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, file) != 1) {
+        return CHESS_SAVE_FAILURE;
+    }
+    return CHESS_SUCCESS;
+}
+
+// points the sections to their places in the data, after checking they fill it exactly
+static bool findSections(const void* data, size_t size, Sections* sections) {
+    const SnapshotHeader* header = data;
+    if (size < sizeof(*header) || memcmp(header->magic, SNAPSHOT_MAGIC, MAGIC_SIZE) != 0 ||
+        header->version != SNAPSHOT_VERSION || header->byte_order != BYTE_ORDER_MARK) {
+        return false;
+    }
+    if (header->tournaments_num < 0 || header->games_num < 0 || header->players_num < 0 ||
+        header->participances_num < 0 || header->game_ids_num < 0 || header->locations_size < 0) {
+        return false;
+    }
+    const char* bytes = data;
+    size_t offset = sizeof(*header);
+    sections->header = header;
+    sections->tournaments = (const TournamentRecord*)(bytes + offset);
+    offset += sizeof(TournamentRecord) * (size_t)header->tournaments_num;
+    sections->games = (const GameRecord*)(bytes + offset);
+    offset += sizeof(GameRecord) * (size_t)header->games_num;
+    sections->players = (const PlayerRecord*)(bytes + offset);
+    offset += sizeof(PlayerRecord) * (size_t)header->players_num;
+    sections->participances = (const ParticipanceRecord*)(bytes + offset);
+    offset += sizeof(ParticipanceRecord) * (size_t)header->participances_num;
+    sections->game_ids = (const int32_t*)(bytes + offset);
+    offset += sizeof(int32_t) * (size_t)header->game_ids_num;
+    sections->locations = bytes + offset;
+    offset += (size_t)header->locations_size;
+    if (offset != size) {
+        return false;
+    }
+    Checksum checksum;
+    checksumStart(&checksum);
+    checksumAdd(&checksum, bytes + sizeof(*header), size - sizeof(*header));
+    return checksumEnd(&checksum) == header->checksum;
+}
+
+static bool isValidLocation(const Sections* sections, int32_t offset) {
+    int32_t size = sections->header->locations_size;
+    return offset >= 0 && offset < size && memchr(sections->locations + offset, '\0', size - offset) != NULL;
+}
+
+static bool isValidGame(const GameRecord* record) {
+    return record->first_player > 0 && record->second_player > 0 &&
+           record->first_player != record->second_player && record->play_time >= 0 &&
+           (record->winner == FIRST_PLAYER || record->winner == SECOND_PLAYER || record->winner == DRAW);
+}
+
+static ChessResult readGames(Tournament tournament, const GameRecord* records, int games_num) {
+    Pool pool = tournamentGetGamesPool(tournament);
+    Map games = tournamentGetGames(tournament);
+    for (int i = 0; i < games_num; i++) {
+        const GameRecord* record = &records[i];
+        if (!isValidGame(record)) {
+            return CHESS_SAVE_FAILURE;
+        }
+        int game_id = i + 1;
+        Game game = gameCreate(pool, game_id, record->first_player, record->second_player,
+                               (Winner)record->winner, record->play_time);
+        if (game == NULL) {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        if (mapPutMove(games, &game_id, game) != MAP_SUCCESS) {
+            gameDestroy(game);
+            return CHESS_OUT_OF_MEMORY;
+        }
+    }
+    return CHESS_SUCCESS;
+}
+
+static ChessResult readTournaments(Sections* sections, Map tournaments) {
+    const SnapshotHeader* header = sections->header;
+    if (mapReserve(tournaments, header->tournaments_num) != MAP_SUCCESS) {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    int games_read = 0;
+    int previous_id = -1;
+    for (int i = 0; i < header->tournaments_num; i++) {
+        const TournamentRecord* record = &sections->tournaments[i];
+        if (!tournamentValidateId(record->id) || record->id <= previous_id || record->max_games_for_player < 0 ||
+            record->games_num < 0 || record->games_num > header->games_num - games_read ||
+            record->participants_num < 0 || !isValidLocation(sections, record->location_offset)) {
+            return CHESS_SAVE_FAILURE;
+        }
+        previous_id = record->id;
+        Tournament tournament = tournamentRestore(record->id, record->max_games_for_player,
+                                                  sections->locations + record->location_offset,
+                                                  record->is_ended != 0, record->winner_id,
+                                                  record->total_play_time, record->longest_play_time);
+        if (tournament == NULL) {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        int tournament_id = record->id;
+        if (mapPutMove(tournaments, &tournament_id, tournament) != MAP_SUCCESS) {
+            tournamentDestroy(tournament);
+            return CHESS_OUT_OF_MEMORY;
+        }
+        if (!tournamentReserve(tournament, record->games_num, record->participants_num)) {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        ChessResult res = readGames(tournament, sections->games + games_read, record->games_num);
+        if (res != CHESS_SUCCESS) {
+            return res;
+        }
+        sections->first_games[i] = games_read;
+        games_read += record->games_num;
+    }
+    return games_read == header->games_num ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+// the index of the record of a tournament, found by its id since the records are sorted by id, or -1
+static int findTournament(const Sections* sections, int tournament_id) {
+    int low = 0;
+    int high = sections->header->tournaments_num - 1;
+    while (low <= high) {
+        int middle = low + (high - low) / 2;
+        if (sections->tournaments[middle].id == tournament_id) {
+            return middle;
+        }
+        if (sections->tournaments[middle].id < tournament_id) {
+            low = middle + 1;
+        }
+        else {
+            high = middle - 1;
+        }
+    }
+    return -1;
+}
+
+// game ids of a participance were given in increasing order, and must be games of the player in the tournament.
+// they are checked against the records, which are much faster to reach than the games in the map.
+static bool isValidGameIds(const Sections* sections, int tournament_index, int player_id,
+                           const int32_t* game_ids, int num_of_games) {
+    const GameRecord* games = sections->games + sections->first_games[tournament_index];
+    int games_num = sections->tournaments[tournament_index].games_num;
+    int previous_id = 0;
+    for (int i = 0; i < num_of_games; i++) {
+        int game_id = game_ids[i];
+        if (game_id <= previous_id || game_id > games_num) {
+            return false;
+        }
+        const GameRecord* game = &games[game_id - 1];
+        if (game->first_player != player_id && game->second_player != player_id) {
+            return false;
+        }
+        previous_id = game_id;
+    }
+    return true;
+}
+
+static bool isValidPlayer(const PlayerRecord* record, int previous_id) {
+    return record->id > 0 && record->id > previous_id && record->wins >= 0 && record->losses >= 0 &&
+           record->draws >= 0 && record->num_of_games >= 0 && record->participances_num >= 0;
+}
+
+static ChessResult readPlayers(const Sections* sections, Map tournaments, Map players, Leaderboard leaderboard) {
+    const SnapshotHeader* header = sections->header;
+    if (mapReserve(players, header->players_num) != MAP_SUCCESS) {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    int participances_read = 0;
+    int game_ids_read = 0;
+    int previous_player_id = 0;
+    for (int i = 0; i < header->players_num; i++) {
+        const PlayerRecord* player = &sections->players[i];
+        if (!isValidPlayer(player, previous_player_id) ||
+            player->participances_num > header->participances_num - participances_read) {
+            return CHESS_SAVE_FAILURE;
+        }
+        previous_player_id = player->id;
+        ChessResult res = playerRestore(players, leaderboard, player->id, player->wins, player->losses,
+                                        player->draws, player->num_of_games, player->play_time,
+                                        player->participances_num);
+        if (res != CHESS_SUCCESS) {
+            return res;
+        }
+        int previous_tournament_id = -1;
+        for (int j = 0; j < player->participances_num; j++) {
+            const ParticipanceRecord* record = &sections->participances[participances_read++];
+            int tournament_id = record->tournament_id;
+            int tournament_index = findTournament(sections, tournament_id);
+            const int32_t* game_ids = sections->game_ids + game_ids_read;
+            if (tournament_index < 0 || tournament_id <= previous_tournament_id || record->num_of_games < 0 ||
+                record->num_of_games > header->game_ids_num - game_ids_read ||
+                !isValidGameIds(sections, tournament_index, player->id, game_ids, record->num_of_games)) {
+                return CHESS_SAVE_FAILURE;
+            }
+            Tournament tournament = mapGet(tournaments, &tournament_id);
+            previous_tournament_id = tournament_id;
+            res = playerRestoreParticipance(players, player->id, tournament, record->wins, record->losses,
+                                            record->draws, game_ids, record->num_of_games);
+            if (res != CHESS_SUCCESS) {
+                return res;
+            }
+            game_ids_read += record->num_of_games;
+        }
+    }
+    if (participances_read != header->participances_num || game_ids_read != header->game_ids_num) {
+        return CHESS_SAVE_FAILURE;
+    }
+    return CHESS_SUCCESS;
+}
+
+// rebuilds the system from the sections of a valid snapshot
+static ChessResult readSections(Sections* sections, Map tournaments, Map players, Leaderboard leaderboard) {
+    ChessResult res = readTournaments(sections, tournaments);
+    if (res != CHESS_SUCCESS) {
+        return res;
+    }
+    res = readPlayers(sections, tournaments, players, leaderboard);
+    if (res != CHESS_SUCCESS) {
+        return res;
+    }
+    MAP_FOREACH_BORROWED(int*, tournament_iter, tournaments) {
+        if (!tournamentRestorePlayedPairs(mapGetCurrent(tournaments))) {
+            return CHESS_OUT_OF_MEMORY;
+        }
+    }
+    return CHESS_SUCCESS;
+}
+
+ChessResult snapshotRead(const void* data, size_t size, Map tournaments, Map players, Leaderboard leaderboard) {
+    Sections sections;
+    if (!findSections(data, size, &sections)) {
+        return CHESS_SAVE_FAILURE;
+    }
+    sections.first_games = malloc(sizeof(*sections.first_games) * (sections.header->tournaments_num + 1));
+    if (sections.first_games == NULL) {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    ChessResult res = readSections(&sections, tournaments, players, leaderboard);
+    free(sections.first_games);
+    return res;
+}
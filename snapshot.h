@@ -0,0 +1,50 @@
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/**
+ * A snapshot is a binary image of the tournaments and the players of a chess system: a header with a version
+ * and a checksum, followed by arrays of fixed size records that are used in place when the snapshot is read,
+ * so it can be mapped to memory and rebuilt without parsing. Records of the same kind are sorted by id, so
+ * every map is filled by appending. Snapshots are only read on machines with the byte order they were written on.
+ */
+
+
+/**
+ * snapshotWrite: writes a snapshot of the tournaments and the players of a chess system to a file.
+ *                Everything that can't be recalculated from the rest is written: the leaderboard, the rosters,
+ *                the standings and the played pairs of the tournaments are rebuilt by snapshotRead.
+ *
+ * @param file - a file opened for writing at its start, which supports seeking. The header is written last,
+ *               once the checksum is known. The file isn't flushed or closed.
+ * @param tournaments - the map of the tournaments of the system.
+ * @param players - the map of the players of the system.
+ *
+ * @return
+ * CHESS_SAVE_FAILURE if writing to the file failed.
+ * CHESS_SUCCESS otherwise.
+ *
+ */
+ChessResult snapshotWrite(FILE* file, Map tournaments, Map players);
+
+/**
+ * snapshotRead: rebuilds the tournaments and the players of a chess system from a snapshot in memory.
+ *
+ * @param data - the snapshot, aligned to 8 bytes.
+ * @param size - the size of the snapshot in bytes.
+ * @param tournaments - an empty map of tournaments to fill.
+ * @param players - an empty map of players to fill.
+ * @param leaderboard - an empty leaderboard to fill.
+ *
+ * @return
+ * CHESS_SAVE_FAILURE if the data isn't a valid snapshot of this version, or its checksum doesn't match.
+ * CHESS_OUT_OF_MEMORY if an allocation failed.
+ * CHESS_SUCCESS otherwise.
+ * On failure the maps and the leaderboard may hold part of the system, and can only be destroyed.
+ *
+ */
+ChessResult snapshotRead(const void* data, size_t size, Map tournaments, Map players, Leaderboard leaderboard);
+
+#endif //_SNAPSHOT_H
@@ -1,5 +1,11 @@
 #include "chessSystem.h"
 #include "map.h"
+#include "mapExtensions.h"
+#include "pool.h"
+#include "pairSet.h"
+#include "leaderboard.h"
+#include "rankTable.h"
+#include "parallel.h"
 #include "tournament.h"
 #include "game.h"
 #include "player.h"
@@ -14,60 +20,40 @@
 #include <ctype.h>
 
 #define UNDEFINED -1
-#define ID 0
-#define WINS 1
-#define LOSSES 2
-#define DRAWS 3
-#define RANK 4
-#define NUM_OF_COMPONENTS 5
 
 struct tournament_t {
-    int* id;
+    int id;
     char* location;
     int winner_id;
     int max_games_for_player;
     bool is_still_going;
+    double total_play_time;
+    int longest_play_time;
     Map games;
+    Map roster;
+    RankTable standings;
+    PairSet played_pairs;
+    Pool games_pool;
+    Pool participances_pool;
+    // the statistics of the ended tournament, made when they are first shared and until they change
+    Statistics statistics;
 };
 
-// get the number of players that have played in this tournament
-static int getPlayersNum(Map players, int tournament_id) {
-    int counter = 0; 
-    Player curr_player;
-    Participance curr_participance;
-    MAP_FOREACH(int*, player_iter, players) {
-        curr_player = mapGet(players, player_iter); //check if player_iter is without &
-        MAP_FOREACH(int*, participance_iter, playerGetParticipances(curr_player)) {
-            curr_participance = mapGet(playerGetParticipances(curr_player), participance_iter);
-            int* curr_id = participanceGetId(curr_participance);
-            if(idCompare(curr_id, &tournament_id) == 0) {
-                counter++;
-            }
-        free(participance_iter);
-        free(curr_id);
-        }
-    free(player_iter);
-    }
-    return counter;   
-}
-
-// get the average game time of all the games in the tournament
-static double getAverageGameTime(Tournament tournament, int* longest_time, int* games_num) {
-    int total_play_time = 0;
-    int current_play_time = 0;
-    Game curr_game;
-    MAP_FOREACH(int*, game_iter, tournament->games) {
-        curr_game = mapGet(tournament->games, game_iter);
-        (*games_num)++;
-        current_play_time = gameGetPlayTime(curr_game);
-        total_play_time += current_play_time;
-        
-        if (current_play_time > *longest_time){
-            *longest_time = current_play_time;     
-        }
-    free(game_iter);
-    }
-    return (double)(total_play_time / *games_num);
+struct statistics_t {
+    // the tournament while it holds the statistics, and every snapshot that shares them
+    int refs;
+    int winner_id;
+    int longest_play_time;
+    double average_play_time;
+    int games_num;
+    int players_num;
+    char location[];
+};
+
+// lets the tournament go of its statistics after they changed, so they are made again when next shared
+static void forgetStatistics(Tournament tournament) {
+    statisticsRelease(tournament->statistics);
+    tournament->statistics = NULL;
 }
 
 int tournamentGetMaxGamesForPlayer(Tournament tournament) {
@@ -85,10 +71,125 @@ Map tournamentGetGames(Tournament tournament) {
     return tournament->games;
 }
 
-int* tournamentGetId(Tournament tournament) {
+int tournamentGetId(Tournament tournament) {
     return tournament->id;
 }
 
+PairSet tournamentGetPlayedPairs(Tournament tournament) {
+    return tournament->played_pairs;
+}
+
+Pool tournamentGetGamesPool(Tournament tournament) {
+    return tournament->games_pool;
+}
+
+Pool tournamentGetParticipancesPool(Tournament tournament) {
+    return tournament->participances_pool;
+}
+
+void tournamentUpdateStandings(Tournament tournament, int player_id) {
+    Participance participance = mapGet(tournament->roster, &player_id);
+    assert(participance != NULL);
+    rankTableUpdate(tournament->standings, participanceGetRankRow(participance), participanceGetWins(participance),
+                    participanceGetLosses(participance), participanceGetDraws(participance));
+}
+
+void tournamentRecordGame(Tournament tournament, int first_player, int second_player, int play_time) {
+    tournamentUpdateStandings(tournament, first_player);
+    tournamentUpdateStandings(tournament, second_player);
+    tournament->total_play_time += play_time;
+    if (play_time > tournament->longest_play_time) {
+        tournament->longest_play_time = play_time;
+    }
+}
+
+bool tournamentAddParticipant(Tournament tournament, int player_id, Participance participance) {
+    if (!rankTableReserve(tournament->standings, rankTableGetSize(tournament->standings) + 1) ||
+        mapPutMove(tournament->roster, &player_id, participance) != MAP_SUCCESS) {
+        return false;
+    }
+    participanceSetRankRow(participance, rankTableAdd(tournament->standings, player_id));
+    return true;
+}
+
+void tournamentRemoveParticipant(Tournament tournament, int player_id) {
+    Participance participance = mapGet(tournament->roster, &player_id);
+    assert(participance != NULL);
+    int rank_row = participanceGetRankRow(participance);
+    // the last row of the standings takes the place of the removed one
+    int moved_player_id = rankTableRemove(tournament->standings, rank_row);
+    if (moved_player_id != UNDEFINED) {
+        participanceSetRankRow(mapGet(tournament->roster, &moved_player_id), rank_row);
+    }
+    mapRemove(tournament->roster, &player_id);
+    forgetStatistics(tournament);
+}
+
+Map tournamentGetRoster(Tournament tournament) {
+    return tournament->roster;
+}
+
+const char* tournamentGetLocation(Tournament tournament) {
+    return tournament->location;
+}
+
+int tournamentGetWinnerId(Tournament tournament) {
+    return tournament->winner_id;
+}
+
+int tournamentGetLongestPlayTime(Tournament tournament) {
+    return tournament->longest_play_time;
+}
+
+double tournamentGetTotalPlayTime(Tournament tournament) {
+    return tournament->total_play_time;
+}
+
+bool tournamentReserve(Tournament tournament, int games_num, int participants_num) {
+    return mapReserve(tournament->games, games_num) == MAP_SUCCESS &&
+           mapReserve(tournament->roster, participants_num) == MAP_SUCCESS &&
+           rankTableReserve(tournament->standings, participants_num);
+}
+
+bool tournamentRestorePlayedPairs(Tournament tournament) {
+    int games_num = mapGetSize(tournament->games);
+    if (games_num == 0) {
+        return true;
+    }
+    // a pair is still in the set exactly when its game is in the participances of both players,
+    // since removing a player drops both his participances and his pairs.
+    // the first player found with each game is kept, so the second one completes the pair.
+    int* first_players = calloc(games_num + 1, sizeof(*first_players));
+    if (first_players == NULL || !pairSetReserve(tournament->played_pairs, games_num)) {
+        free(first_players);
+        return false;
+    }
+    MAP_FOREACH_BORROWED(int*, player_iter, tournament->roster) {
+        Participance participance = mapGetCurrent(tournament->roster);
+        const int* game_ids = participanceGetGames(participance);
+        for (int i = 0; i < participanceGetNumOfGames(participance); i++) {
+            assert(game_ids[i] >= 1 && game_ids[i] <= games_num);
+            if (first_players[game_ids[i]] == 0) {
+                first_players[game_ids[i]] = *player_iter;
+            }
+            else {
+                // the set was reserved for every game, so adding can't fail
+                pairSetAdd(tournament->played_pairs, first_players[game_ids[i]], *player_iter);
+            }
+        }
+    }
+    free(first_players);
+    return true;
+}
+
+// the roster only points to participances that belong to the players, so it neither copies nor frees them
+static MapDataElement rosterElementCopy(MapDataElement participance) {
+    return participance;
+}
+
+static void rosterElementFree(MapDataElement participance) {
+}
+
 int idCompare(MapKeyElement id1, MapKeyElement id2) {
     return (*(int*)id1 - *(int*)id2);
 }
@@ -116,100 +217,57 @@ void winnerIdUpdate(Map tournaments, int tournament_id, int winner_id){
     // all conditions are checked in the mother-function
     Tournament tournament = mapGet(tournaments, &tournament_id);
     tournament->winner_id = winner_id;
+    forgetStatistics(tournament);
 }
 
-// get the winner id by making the calculation of it score
-static int CalculateWinnerId(double** player_rank, int size) {
-    int winner_index = 0;
-    double max_rank = 0;
-    for(int i = 0; i < size; i++){
-        if(player_rank[i][RANK] > player_rank[winner_index][RANK]){
-            winner_index = i;
-            max_rank = player_rank[winner_index][RANK];
-        }
-        else if(player_rank[i][RANK] == max_rank){
-            if(player_rank[i][LOSSES] < player_rank[winner_index][LOSSES]){
-                winner_index =i;
-                max_rank = player_rank[winner_index][RANK];
-            }
-            else if (player_rank[i][LOSSES] == player_rank[winner_index][LOSSES]){
-                if(player_rank[i][WINS] > player_rank[winner_index][WINS]){
-                    winner_index =i;
-                    max_rank = player_rank[winner_index][RANK];
-                }
-                else if (player_rank[i][WINS] == player_rank[winner_index][WINS]){
-                    if (player_rank[i][ID] < player_rank[winner_index][ID]){
-                        winner_index =i;
-                        max_rank = player_rank[winner_index][RANK];
-                    }
-                    else {
-                        continue;
-                    }
-                }
-                else {
-                    continue;
-                }
-            }
-            else {
-                continue;
-            }
-        }
-        else {
-            continue;
-        }
+static ChessResult printRecord(FILE* statistics, int winner_id, int longest_time, double average_game_time,
+                               const char* location, int games_num, int num_of_players) {
+    if (fprintf(statistics, "%d\n%d\n%.2lf\n%s\n%d\n%d\n", winner_id, longest_time,
+        average_game_time, location, games_num, num_of_players) < 0) {
+        return CHESS_SAVE_FAILURE;
     }
-    return player_rank[winner_index][ID];
-}
-
-// sets the array of the players rank by putting in the data of their ids, numbers of wins, losses and draws
-static void arraySet(double** player_rank, Map players, int tournament_id) {
-    int counter = 0;
-    Player curr_player;
-    Participance curr_participance;
-    Map player_participances;
-    MAP_FOREACH(int*, player_iter, players) {
-        curr_player = mapGet(players, player_iter);
-        assert(curr_player != NULL);
-        player_participances = playerGetParticipances(curr_player);
-        assert(player_participances != NULL);
-        MAP_FOREACH(int*, participance_iter, player_participances)  {
-            curr_participance = mapGet(player_participances, participance_iter);
-            if(idCompare(participance_iter, &tournament_id) == 0) {
-                int* id = participanceGetId(curr_participance);
-                player_rank[counter][ID] = *id;
-                int wins = participanceGetWins(curr_participance);
-                player_rank[counter][WINS] = wins;
-                int losses =  participanceGetLosses(curr_participance);
-                player_rank[counter][LOSSES] = losses;
-                int draws = participanceGetDraws(curr_participance);
-                player_rank[counter][DRAWS] = draws;
-                double rank = 2*participanceGetWins(curr_participance) + 1*participanceGetDraws(curr_participance);
-                player_rank[counter][RANK] = rank;
-                free(id);
-            }
-            free(participance_iter);
+    return CHESS_SUCCESS;
+}
+
+static double averagePlayTime(Tournament tournament) {
+    int games_num = mapGetSize(tournament->games);
+    return games_num == 0 ? 0 : tournament->total_play_time / games_num;
+}
+
+ChessResult printStatistics(FILE* statistics, Tournament tournament) {
+    return printRecord(statistics, tournament->winner_id, tournament->longest_play_time, averagePlayTime(tournament),
+                       tournament->location, mapGetSize(tournament->games), mapGetSize(tournament->roster));
+}
+
+Statistics tournamentShareStatistics(Tournament tournament) {
+    assert(tournamentCheckIfEnded(tournament));
+    if (tournament->statistics == NULL) {
+        Statistics statistics = malloc(sizeof(*statistics) + strlen(tournament->location) + 1);
+        if (statistics == NULL) {
+            return NULL;
         }
-        free(player_iter);
-    counter++;
+        statistics->refs = 1;
+        statistics->winner_id = tournament->winner_id;
+        statistics->longest_play_time = tournament->longest_play_time;
+        statistics->average_play_time = averagePlayTime(tournament);
+        statistics->games_num = mapGetSize(tournament->games);
+        statistics->players_num = mapGetSize(tournament->roster);
+        strcpy(statistics->location, tournament->location);
+        tournament->statistics = statistics;
     }
+    __atomic_fetch_add(&tournament->statistics->refs, 1, __ATOMIC_RELAXED);
+    return tournament->statistics;
 }
 
-ChessResult printStatistics(Map players, char* path_file, Tournament tournament) {
-    FILE* statistics = fopen(path_file, "w");
-    if (statistics == NULL)
-        return CHESS_SAVE_FAILURE; 
-    int winner_id = tournament->winner_id;
-    int longest_time = 0, games_num = 0;
-    double average_game_time = getAverageGameTime(tournament, &longest_time, &games_num);
-    char *location = tournament->location;
-    int num_of_players = getPlayersNum(players, *(tournament->id));
-    if(!fprintf(statistics, "%d\n%d\n%.2lf\n%s\n%d\n%d\n", winner_id, longest_time,
-        average_game_time, location, games_num, num_of_players)){
-        fclose(statistics);
-        return CHESS_SAVE_FAILURE;
-    }   
-    fclose(statistics);        
-    return CHESS_SUCCESS;
+void statisticsRelease(Statistics statistics) {
+    if (statistics != NULL && __atomic_sub_fetch(&statistics->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(statistics);
+    }
+}
+
+ChessResult statisticsPrint(FILE* file, Statistics statistics) {
+    return printRecord(file, statistics->winner_id, statistics->longest_play_time, statistics->average_play_time,
+                       statistics->location, statistics->games_num, statistics->players_num);
 }
 
 // validate the given location of the tournament. Must start with capital letter that is followed by small letters or spaces.
@@ -226,6 +284,36 @@ static bool tournamentValidateLocation(const char* tournament_location) {
     return true;
 }
 
+// allocates a tournament with its location, its pools and an empty map of games
+static Tournament tournamentAllocate(const char* tournament_location) {
+    Tournament tournament = malloc(sizeof(*tournament));
+    if (tournament == NULL) {
+        return NULL;
+    }
+    tournament->games_pool = gamePoolCreate();
+    tournament->participances_pool = participancePoolCreate();
+    tournament->games = mapCreateIntKeyed(gameCopy, gameDestroy);
+    tournament->roster = mapCreateIntKeyed(rosterElementCopy, rosterElementFree);
+    tournament->standings = rankTableCreate();
+    tournament->played_pairs = NULL;
+    tournament->statistics = NULL;
+    tournament->location = malloc(sizeof(*(tournament->location))*strlen(tournament_location)+1);
+    if (tournament->games_pool == NULL || tournament->participances_pool == NULL ||
+        tournament->games == NULL || tournament->roster == NULL ||
+        tournament->standings == NULL || tournament->location == NULL) {
+        free(tournament->location);
+        mapDestroy(tournament->games);
+        mapDestroy(tournament->roster);
+        rankTableDestroy(tournament->standings);
+        poolDestroy(tournament->games_pool);
+        poolDestroy(tournament->participances_pool);
+        free(tournament);
+        return NULL;
+    }
+    strcpy(tournament->location, tournament_location);
+    return tournament;
+}
+
 Tournament tournamentCreate(Map tournaments, int tournament_id, int max_games_per_player,
                             const char* tournament_location, ChessResult* chess_result) {
     if (tournament_location == NULL){
@@ -249,82 +337,100 @@ Tournament tournamentCreate(Map tournaments, int tournament_id, int max_games_pe
         return NULL; 
     }
     
-    Tournament tournament = malloc(sizeof(*tournament));
+    Tournament tournament = tournamentAllocate(tournament_location);
     if (tournament == NULL){
         return NULL;
     }
-    Map games = mapCreate(gameCopy, idCopy, gameDestroy, idFree, idCompare);
-    if (games == NULL){
-        return NULL;
-    }
-    tournament->games = games;
-    tournament->id = malloc(sizeof(*(tournament->id)));
-    if (tournament->id == NULL){
-        mapDestroy(games);
-        free(tournament);
-        return NULL;
-    }
-    *(tournament->id) = tournament_id;
-
-    tournament->location = malloc(sizeof(*(tournament->location))*strlen(tournament_location)+1);
-    if (tournament->location == NULL) {
-        free(tournament->id);
-        mapDestroy(games);
-        free(tournament);
+    tournament->played_pairs = pairSetCreate();
+    if (tournament->played_pairs == NULL){
+        tournamentDestroy(tournament);
         return NULL;
     }
-    strcpy(tournament->location, tournament_location);
+    tournament->id = tournament_id;
     tournament->winner_id = UNDEFINED; 
     tournament->max_games_for_player = max_games_per_player;
     tournament-> is_still_going = true; 
+    tournament->total_play_time = 0;
+    tournament->longest_play_time = 0;
     
     return tournament; 
 }
 
+Tournament tournamentRestore(int tournament_id, int max_games_per_player, const char* tournament_location,
+                             bool is_ended, int winner_id, double total_play_time, int longest_play_time) {
+    Tournament tournament = tournamentAllocate(tournament_location);
+    if (tournament == NULL) {
+        return NULL;
+    }
+    tournament->played_pairs = pairSetCreate();
+    if (tournament->played_pairs == NULL) {
+        tournamentDestroy(tournament);
+        return NULL;
+    }
+    tournament->id = tournament_id;
+    tournament->winner_id = winner_id;
+    tournament->max_games_for_player = max_games_per_player;
+    tournament->is_still_going = !is_ended;
+    tournament->total_play_time = total_play_time;
+    tournament->longest_play_time = longest_play_time;
+    return tournament;
+}
+
 MapDataElement tournamentCopy(MapDataElement tournament_to_copy) {
     if (tournament_to_copy == NULL){
         return NULL;
     }
-    Tournament tournament_copy = (Tournament)malloc(sizeof(*tournament_copy));
+    Tournament tournament = tournament_to_copy;
+    Tournament tournament_copy = tournamentAllocate(tournament->location);
     if (tournament_copy == NULL) {
         return NULL;
     }
-    Tournament tournament = tournament_to_copy;
-    tournament_copy->games = mapCopy(tournament->games); 
-    if (tournament_copy->games == NULL) {
-        free(tournament_copy);
+    tournament_copy->played_pairs = pairSetCopy(tournament->played_pairs);
+    if (tournament_copy->played_pairs == NULL) {
+        tournamentDestroy(tournament_copy);
         return NULL;
     }
-    
-    tournament_copy->id = malloc(sizeof(*(tournament_copy->id)));
-    if (tournament_copy->id == NULL ){
-        mapDestroy(tournament->games);
-        free(tournament_copy);
+    rankTableDestroy(tournament_copy->standings);
+    tournament_copy->standings = rankTableCopy(tournament->standings);
+    if (tournament_copy->standings == NULL) {
+        tournamentDestroy(tournament_copy);
         return NULL;
     }
-    *(tournament_copy->id) = *(tournament->id);
-
-    tournament_copy->location = malloc(sizeof(*tournament_copy->location)*strlen(tournament->location)+1);
-    if (tournament_copy->location == NULL) {
-        free(tournament_copy->id);
-        mapDestroy(tournament_copy->games);
-        free(tournament_copy);
-        return NULL;
+    // the roster of the copy points to the same participances, which belong to the players
+    MAP_FOREACH_BORROWED(int*, player_iter, tournament->roster) {
+        if (mapPutMove(tournament_copy->roster, player_iter, mapGetCurrent(tournament->roster)) != MAP_SUCCESS) {
+            tournamentDestroy(tournament_copy);
+            return NULL;
+        }
     }
-    strcpy(tournament_copy->location, tournament->location);
+    // the games of the copy are allocated from its own pool, so they outlive the original tournament
+    MAP_FOREACH_BORROWED(int*, game_iter, tournament->games) {
+        Game game_copy = gameCopyToPool(mapGetCurrent(tournament->games), tournament_copy->games_pool);
+        if (game_copy == NULL || mapPutMove(tournament_copy->games, game_iter, game_copy) != MAP_SUCCESS) {
+            tournamentDestroy(tournament_copy);
+            return NULL;
+        }
+    }
+    tournament_copy->id = tournament->id;
     tournament_copy->winner_id = tournament-> winner_id;
     tournament_copy->max_games_for_player = tournament->max_games_for_player;
     tournament_copy->is_still_going = tournament->is_still_going;
+    tournament_copy->total_play_time = tournament->total_play_time;
+    tournament_copy->longest_play_time = tournament->longest_play_time;
 
     return (MapDataElement)tournament_copy;
 }
 
 void tournamentDestroy(Tournament tournament) {
+    statisticsRelease(tournament->statistics);
     free(tournament->location);
-    free(tournament->id);
-    if(tournament->games != NULL){
-        mapDestroy(tournament->games);
-    }
+    mapDestroy(tournament->games);
+    mapDestroy(tournament->roster);
+    rankTableDestroy(tournament->standings);
+    pairSetDestroy(tournament->played_pairs);
+    // every game and participance of the tournament is freed at once with its pool
+    poolDestroy(tournament->games_pool);
+    poolDestroy(tournament->participances_pool);
     free(tournament);
 }
 
@@ -334,46 +440,12 @@ void tournamentEnd(Map tournaments, int tournament_id) {
 }
 
 
-double** playersRankArrayCreate(int player_size, int num_of_components) {
-    double** array = malloc(sizeof(*array)*player_size);
-    if(array == NULL {
-        return NULL;
-    }
-    for(int i = 0; i < player_size; i++) {
-        array[i] = malloc(sizeof(double)*num_of_components);
-        if(array[i] == NULL){
-            for(int j = 0; j < i; j++){
-                free(array[j]);
-            }
-            free(array);
-            return NULL; 
-        }
-    }
-    return array;
-}
-
-void destroyArray(Map map, double** array) {
-    for(int i = 0; i < mapGetSize(map); i++)
-        free(array[i]);
-    free(array);
-}
-
-
 bool tournamentCheckIfEnded(Tournament tournament) {
     if(tournament->is_still_going == false)
         return true;
     return false;
 }
 
-int tournamentCalculateWinnerId(Map tournaments, Map players, int tournament_id) {
-    int players_size = mapGetSize(players);
-    double** player_rank = playersRankArrayCreate(players_size, NUM_OF_COMPONENTS);
-    if(player_rank == NULL){
-        return UNDEFINED;
-    }
-    arraySet(player_rank, players, tournament_id);
-    int winner_id = CalculateWinnerId(player_rank, players_size); 
-    destroyArray(players, player_rank);
-
-    return winner_id;
+int tournamentCalculateWinnerId(Tournament tournament) {
+    return rankTableGetBest(tournament->standings);
 }
@@ -3,11 +3,19 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include "participance.h"
+#include "rankTable.h"
 
 
 /** Type for representing one tournament */
 typedef struct tournament_t *Tournament;
 
+/**
+ * Type for the statistics of an ended tournament, as printStatistics prints them. They never change once made:
+ * when the tournament changes, it lets go of them and makes new ones, so snapshots can share them.
+ */
+typedef struct statistics_t *Statistics;
+
 
 /**
  * tournamentCreate: allocates a new tournament.
@@ -26,6 +34,24 @@ typedef struct tournament_t *Tournament;
 Tournament tournamentCreate(Map tournaments, int tournament_id, int max_games_per_player,
                             const char* tournament_location, ChessResult* chess_result);
 
+/**
+ * tournamentRestore: allocates a tournament in a given state, as it was saved by a snapshot of the system.
+ *                    Nothing is validated, and the tournament has no games, participants or played pairs yet.
+ *
+ * @param tournament_id - the id of the tournament.
+ * @param max_games_per_player - the maximum number of games a player can take part in for this tournament.
+ * @param tournament_location - the location of the tournament. Must be non-NULL.
+ * @param is_ended - whether the tournament is over.
+ * @param winner_id - the id of the winner of the tournament, or -1 if there is none.
+ * @param total_play_time - the sum of the times of the games in the tournament.
+ * @param longest_play_time - the longest time of a game in the tournament.
+ *
+ * @return
+ * NULL if the allocation failed, or a pointer to the new tournament otherwise.
+ *
+ */
+Tournament tournamentRestore(int tournament_id, int max_games_per_player, const char* tournament_location,
+                             bool is_ended, int winner_id, double total_play_time, int longest_play_time);
 
 /**
  * tournamentCopy: duplicate a given tournament - allocate a new one and copy all the data.
@@ -64,15 +90,18 @@ void tournamentEnd(Map tournaments, int tournament_id);
  *                              If two players have the same number of wins and losses,
  *                              the player with smaller id will be chosen.
  * 
- * @param tournaments - a map of all the tournaments in the chess system.
- * @param players - a map of all the players in the chess system.
- * @param tournament_id - the tournament of which the winner is calculated.
+ *                              Only the players in the roster of the tournament are ranked. Their results
+ *                              are kept in the standings of the tournament as games are added, so nothing
+ *                              is allocated or gathered here. The tournament is only read, so the winners
+ *                              of different tournaments may be calculated at the same time.
+ * 
+ * @param tournament - the tournament of which the winner is calculated.
  * 
  * @return
- * the id of the winner
+ * -1 if no player in the tournament is left in the chess system, or the id of the winner otherwise.
  * 
  */
-int tournamentCalculateWinnerId(Map tournaments, Map players, int tournament_id);
+int tournamentCalculateWinnerId(Tournament tournament);
 
 /**
  * IdCompare: compare two ids.
@@ -106,17 +135,47 @@ bool tournamentCheckIfEnded(Tournament tournament);
  *                  the tournament location,
  *                  the number of games in the tournament,
  *                  the number of players who took part in the tournament.
+ *                  All of them are kept up to date while games are added and players removed,
+ *                  so nothing is counted here. The file isn't flushed or closed, so the statistics of
+ *                  several tournaments can be printed to one buffered stream.
  *        
- * @param players - a map of all the players in the chess system.
- * @param path_file - the path of the file to which the statistics are printed to,
+ * @param statistics - the open file to which the statistics are printed to,
  * @param tournament - the tournament which its statistics are checked and printed.
  * 
  * @return
- * CHESS_SAVE_FAILURE if the file failed to open or to save the statistics printed to it.
+ * CHESS_SAVE_FAILURE if the statistics failed to be printed to the file.
  * CHESS_SUCCESS otherwise.
  * 
  */
-ChessResult printStatistics(Map players, char* path_file, Tournament tournament);
+ChessResult printStatistics(FILE* statistics, Tournament tournament);
+
+/**
+ * tournamentShareStatistics: gives the statistics of an ended tournament to share, making them the first time.
+ *                            They must be let go of with statisticsRelease, by any thread.
+ *
+ * @param tournament - the ended tournament.
+ *
+ * @return
+ * NULL if the allocation failed, or the statistics otherwise.
+ *
+ */
+Statistics tournamentShareStatistics(Tournament tournament);
+
+/**
+ * statisticsRelease: lets go of statistics given by tournamentShareStatistics, and frees them once nothing
+ *                    holds them. Does nothing if statistics is NULL.
+ */
+void statisticsRelease(Statistics statistics);
+
+/**
+ * statisticsPrint: prints shared statistics to a file, exactly as printStatistics printed them when they were made.
+ *
+ * @return
+ * CHESS_SAVE_FAILURE if the statistics failed to be printed to the file.
+ * CHESS_SUCCESS otherwise.
+ *
+ */
+ChessResult statisticsPrint(FILE* file, Statistics statistics);
 
 
 /**
@@ -140,27 +199,6 @@ int tournamentGetMaxGamesForPlayer(Tournament tournament);
  */
 bool gameCheckIfInTournament(Tournament tournament, int game_id);
 
-/**
- *  playersRankArrayCreate: creates an array to save the rank of the players.
- *                          
- * @param player_size - the number of all players in the system.
- * @param num_of_components - number of different type of players' data needs to be saved.
- * 
- * @return
- * NULL in case the allocation failed, or the array allocated otherwise.
- * 
- */
-double** playersRankArrayCreate(int player_size, int num_of_components);
-
-/**
- *  destroyArray: deallocated a given array
- *                          
- * @param map - the map that its size is the array size.
- * @param array - the array to deallocate
- * 
- */
-void destroyArray(Map map, double** array);
-
 /**
  *  tournamentGetGames: get the tournamnet's map of games.
  *                          
@@ -181,7 +219,170 @@ Map tournamentGetGames(Tournament tournament);
  * the tournament's id
  * 
  */
-int* tournamentGetId(Tournament tournament);
+int tournamentGetId(Tournament tournament);
+
+/**
+ *  tournamentGetPlayedPairs: get the set of pairs of players that have a game in the tournament.
+ *                            A pair is removed from the set once one of its players is removed from the system.
+ *
+ * @param tournament - a specific tournament his set of pairs the function gets.
+ *
+ * @return
+ * set of pairs of players
+ *
+ */
+PairSet tournamentGetPlayedPairs(Tournament tournament);
+
+/**
+ *  tournamentGetGamesPool: get the pool the games of the tournament are allocated from.
+ *                          All of them are freed together with the tournament.
+ *
+ * @param tournament - a specific tournament his pool of games the function gets.
+ *
+ * @return
+ * the pool of games
+ *
+ */
+Pool tournamentGetGamesPool(Tournament tournament);
+
+/**
+ *  tournamentGetParticipancesPool: get the pool the participances of players in the tournament are allocated from.
+ *                                  All of them are freed together with the tournament, so they must be removed
+ *                                  from the players before the tournament is destroyed.
+ *
+ * @param tournament - a specific tournament his pool of participances the function gets.
+ *
+ * @return
+ * the pool of participances
+ *
+ */
+Pool tournamentGetParticipancesPool(Tournament tournament);
+
+/**
+ *  tournamentRecordGame: updates the statistics and the standings of the tournament with a new game, after the
+ *                        participances of both players were updated with its result.
+ *
+ * @param tournament - the tournament the game was added to.
+ * @param first_player - the id of the first player in the game.
+ * @param second_player - the id of the second player in the game.
+ * @param play_time - the time of the game.
+ *
+ */
+void tournamentRecordGame(Tournament tournament, int first_player, int second_player, int play_time);
+
+/**
+ *  tournamentAddParticipant: adds a player that has just started to take part in the tournament to its roster,
+ *                            and a row with no results for him to its standings.
+ *
+ * @param tournament - the tournament the player takes part in.
+ * @param player_id - the id of the player.
+ * @param participance - the participance of the player in the tournament. It still belongs to the player,
+ *                       and must stay alive until the player is removed from the roster or the tournament destroyed.
+ *
+ * @return false if the allocation failed, or true otherwise.
+ *
+ */
+bool tournamentAddParticipant(Tournament tournament, int player_id, Participance participance);
+
+/**
+ *  tournamentRemoveParticipant: removes a player that took part in the tournament and is removed from its roster
+ *                               and its standings.
+ *
+ * @param tournament - the tournament the player took part in.
+ * @param player_id - the id of the player.
+ *
+ */
+void tournamentRemoveParticipant(Tournament tournament, int player_id);
+
+/**
+ *  tournamentGetRoster: get the roster of the tournament, a map from the id of every player that takes part in it
+ *                       to the participance of the player. The participances belong to the players.
+ *
+ * @param tournament - a specific tournament his roster the function gets.
+ *
+ * @return
+ * the roster of the tournament
+ *
+ */
+Map tournamentGetRoster(Tournament tournament);
+
+/**
+ *  tournamentGetLocation: get the location of the tournament.
+ *
+ * @param tournament - a specific tournament his location the function gets.
+ *
+ * @return
+ * the location of the tournament. It belongs to the tournament.
+ *
+ */
+const char* tournamentGetLocation(Tournament tournament);
+
+/**
+ *  tournamentGetWinnerId: get the id of the winner of the tournament.
+ *
+ * @param tournament - a specific tournament his winner the function gets.
+ *
+ * @return
+ * the id of the winner, or -1 if the tournament has no winner.
+ *
+ */
+int tournamentGetWinnerId(Tournament tournament);
+
+/**
+ *  tournamentGetLongestPlayTime: get the longest time of a game in the tournament.
+ *
+ * @param tournament - a specific tournament his longest game time the function gets.
+ *
+ * @return
+ * the longest game time, or 0 if the tournament has no games.
+ *
+ */
+int tournamentGetLongestPlayTime(Tournament tournament);
+
+/**
+ *  tournamentGetTotalPlayTime: get the sum of the times of all the games in the tournament.
+ *
+ * @param tournament - a specific tournament his total game time the function gets.
+ *
+ * @return
+ * the total game time.
+ *
+ */
+double tournamentGetTotalPlayTime(Tournament tournament);
+
+/**
+ *  tournamentUpdateStandings: copies the results of a player in the roster to his row in the standings.
+ *
+ * @param tournament - the tournament the player takes part in.
+ * @param player_id - the id of the player. Must be in the roster.
+ *
+ */
+void tournamentUpdateStandings(Tournament tournament, int player_id);
+
+/**
+ *  tournamentReserve: makes room in the tournament for a given number of games and participants,
+ *                     so adding them makes no further allocations in its maps and standings.
+ *
+ * @param tournament - the tournament to make room in.
+ * @param games_num - the number of games.
+ * @param participants_num - the number of participants.
+ *
+ * @return false if an allocation failed, or true otherwise.
+ *
+ */
+bool tournamentReserve(Tournament tournament, int games_num, int participants_num);
+
+/**
+ *  tournamentRestorePlayedPairs: fills the empty set of played pairs of a restored tournament, after its games
+ *                                and the participances of its players were restored. A pair is played when
+ *                                its game is in the participances of both of its players.
+ *
+ * @param tournament - the restored tournament. The game ids in its participances must be ids of its games.
+ *
+ * @return false if an allocation failed, or true otherwise.
+ *
+ */
+bool tournamentRestorePlayedPairs(Tournament tournament);
 
 
 /**